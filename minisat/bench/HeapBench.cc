@@ -0,0 +1,147 @@
+/************************************************************************************[HeapBench.cc]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+// Microbenchmark for 'Heap' with different arities. Two workloads are timed for each arity:
+//
+//   vsids -- mimics the decision heap of 'Solver': per round, pop a number of variables (decisions),
+//            bump the activity of some of them and of other random variables, then put the popped
+//            ones back (backtracking).
+//   elim  -- mimics the elimination heap of 'SimpSolver': build the heap from all keys, then remove
+//            them all in order.
+//
+// All arities get the same random input. Keys with equal activity may come out in a different
+// order, so the runs diverge somewhat (as the checksums show).
+
+#include <stdio.h>
+
+#include "minisat/mtl/Heap.h"
+#include "minisat/mtl/Rnd.h"
+#include "minisat/utils/System.h"
+#include "minisat/utils/Options.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+
+
+struct ActLt {
+    const vec<double>& act;
+    ActLt(const vec<double>& a) : act(a) {}
+    bool operator()(int x, int y) const { return act[x] > act[y]; }
+};
+
+
+template<int D>
+static double vsids(int n_keys, int rounds, int decs, int bumps, uint64_t& check)
+{
+    double      seed = 91648253;
+    vec<double> act(n_keys, 0);
+    vec<int>    popped;
+    double      inc = 1;
+    Heap<int,ActLt,MkIndexDefault<int>,D> h((ActLt(act)));
+
+    for (int i = 0; i < n_keys; i++){
+        act[i] = drand(seed) * 0.00001;
+        h.insert(i); }
+
+    double start = cpuTime();
+    for (int r = 0; r < rounds; r++){
+        popped.clear();
+        for (int i = 0; i < decs && !h.empty(); i++)
+            popped.push(h.removeMin());
+
+        for (int i = 0; i < bumps; i++){
+            int x = (i & 1) && popped.size() > 0 ? popped[irand(seed, popped.size())] : irand(seed, n_keys);
+            if ((act[x] += inc) > 1e100){
+                for (int k = 0; k < n_keys; k++)
+                    act[k] *= 1e-100;
+                inc *= 1e-100; }
+            if (h.inHeap(x))
+                h.decrease(x);
+        }
+        inc *= 1 / 0.95;
+
+        for (int i = popped.size()-1; i >= 0; i--)
+            h.insert(popped[i]);
+        check += popped[0];
+    }
+    return cpuTime() - start;
+}
+
+
+template<int D>
+static double elim(int n_keys, int rounds, uint64_t& check)
+{
+    double      seed = 91648253;
+    vec<double> act(n_keys, 0);
+    vec<int>    ks;
+    Heap<int,ActLt,MkIndexDefault<int>,D> h((ActLt(act)));
+
+    for (int i = 0; i < n_keys; i++){
+        ks.push(i);
+        h.insert(i); }
+    h.clear();
+
+    double start = cpuTime();
+    for (int r = 0; r < rounds; r++){
+        for (int i = 0; i < n_keys; i++)
+            act[i] = (double)irand(seed, 1000);
+        h.build(ks);
+        while (!h.empty())
+            check += h.removeMin();
+    }
+    return cpuTime() - start;
+}
+
+
+template<int D>
+static void run(int n_keys, int rounds, int decs, int bumps, int elim_rounds)
+{
+    uint64_t check = 0;
+    double   t_vsids = vsids<D>(n_keys, rounds, decs, bumps, check);
+    double   t_elim  = elim<D> (n_keys, elim_rounds, check);
+    printf("| arity %2d | vsids %8.3f s | elim %8.3f s | (check %llu)\n", D, t_vsids, t_elim, (unsigned long long)check);
+}
+
+
+//=================================================================================================
+// Main:
+
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options]\n\n  Times 'Heap' with arities 2, 4, 8 and 16.\n");
+
+    IntOption keys  ("BENCH", "keys",   "Number of keys in the heap.", 1000000, IntRange(1, INT32_MAX));
+    IntOption rounds("BENCH", "rounds", "Number of rounds of the 'vsids' workload.", 200000, IntRange(0, INT32_MAX));
+    IntOption decs  ("BENCH", "decs",   "Number of keys popped in each 'vsids' round.", 100, IntRange(1, INT32_MAX));
+    IntOption bumps ("BENCH", "bumps",  "Number of keys bumped in each 'vsids' round.", 50, IntRange(0, INT32_MAX));
+    IntOption erounds("BENCH", "elim-rounds", "Number of rounds of the 'elim' workload.", 5, IntRange(0, INT32_MAX));
+
+    parseOptions(argc, argv, true);
+
+    printf("keys = %d, rounds = %d (%d pops, %d bumps), elim rounds = %d\n", (int)keys, (int)rounds, (int)decs, (int)bumps, (int)erounds);
+    run<2> (keys, rounds, decs, bumps, erounds);
+    run<4> (keys, rounds, decs, bumps, erounds);
+    run<8> (keys, rounds, decs, bumps, erounds);
+    run<16>(keys, rounds, decs, bumps, erounds);
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+/************************************************************************************[ParseBench.cc]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+// Benchmark for the DIMACS input paths. The same file is parsed into a fresh 'Solver' by:
+//
+//   gzread  -- 'parse_DIMACS(gzFile)', the stream through zlib (also for plain files).
+//   mmap    -- 'parse_DIMACS(MappedFile)' on one thread: the pointer scanner over the mapped file.
+//   memory  -- 'parse_DIMACS(const char*, size_t)' on a copy of the file in memory (as a caller
+//              that already holds the CNF would do). The copy is not timed.
+//   chunks  -- 'parse_DIMACS(MappedFile)' with '-threads' threads tokenizing in parallel.
+//   binary  -- 'parse_BinaryCNF(MappedFile)' on the file given by '-binary', which is first written
+//              from the input by 'Solver::toBinary()' (not timed). Skipped without '-binary'.
+//
+// Wall-clock times are the best of '-rounds' runs. The number of variables and clauses of every
+// path is printed, and must agree.
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+#include <chrono>
+
+#include "minisat/core/Dimacs.h"
+#include "minisat/core/BinaryCnf.h"
+#include "minisat/core/Solver.h"
+#include "minisat/utils/System.h"
+#include "minisat/utils/Options.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+
+
+static double wallTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+enum { path_Gzread, path_Mmap, path_Memory, path_Chunks, path_Binary };
+static const char* path_names[] = { "gzread", "mmap", "memory", "chunks", "binary" };
+
+
+static double parse(int path, const char* file, const char* copy, size_t copy_size, int threads, int& vars, int& clauses)
+{
+    Solver S;
+    double start = wallTime();
+    switch (path){
+    case path_Gzread: {
+        gzFile in = gzopen(file, "rb");
+        if (in == NULL)
+            printf("ERROR! Could not open file: %s\n", file), exit(1);
+        parse_DIMACS(in, S);
+        gzclose(in);
+        break; }
+    case path_Mmap:
+    case path_Chunks: {
+        MappedFile in;
+        if (!in.open(file))
+            printf("ERROR! Could not map file: %s\n", file), exit(1);
+        parse_DIMACS(in, S, false, path == path_Chunks ? threads : 1);
+        break; }
+    case path_Memory:
+        parse_DIMACS(copy, copy_size, S);
+        break;
+    case path_Binary: {
+        MappedFile in;
+        if (!in.open(file))
+            printf("ERROR! Could not map file: %s\n", file), exit(1);
+        parse_BinaryCNF(in, S);
+        break; }
+    }
+    double time = wallTime() - start;
+    vars    = S.nVars();
+    clauses = S.nClauses();
+    return time;
+}
+
+
+//=================================================================================================
+// Main:
+
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options] <input-file>\n\n  Times the DIMACS (and binary CNF) input paths on an uncompressed file.\n");
+
+    IntOption    rounds ("BENCH", "rounds",  "Number of runs of each path (the best is reported).", 3, IntRange(1, INT32_MAX));
+    IntOption    threads("BENCH", "threads", "Number of threads of the 'chunks' path.", 4, IntRange(1, 1024));
+    StringOption binary ("BENCH", "binary",  "Write the input to this file in binary CNF format, and time loading it.");
+
+    parseOptions(argc, argv, true);
+    if (argc != 2)
+        printUsageAndExit(argc, argv);
+
+    // The in-memory copy:
+    vec<char> copy;
+    {
+        MappedFile in;
+        if (!in.open(argv[1]) || in.isGzip() || in.size() > INT32_MAX)
+            printf("ERROR! Not an uncompressed file below 2GB: %s\n", argv[1]), exit(1);
+        copy.growTo((int)in.size());
+        memcpy((char*)copy, in.data(), in.size());
+    }
+    if (binary){
+        Solver S;
+        parse_DIMACS((char*)copy, copy.size(), S);
+        S.toBinary((const char*)binary);
+    }
+
+    printf("file = %s (%.1f MB), rounds = %d, threads = %d\n", argv[1], copy.size() / 1048576.0, (int)rounds, (int)threads);
+    double base = 0;
+    for (int path = path_Gzread; path <= (binary ? path_Binary : path_Chunks); path++){
+        double      best = 0;
+        int         vars = 0, clauses = 0;
+        const char* file = path == path_Binary ? (const char*)binary : argv[1];
+        for (int r = 0; r < rounds; r++){
+            double t = parse(path, file, (char*)copy, copy.size(), threads, vars, clauses);
+            if (r == 0 || t < best) best = t; }
+        if (path == path_Gzread) base = best;
+        printf("| %-6s | %8.3f s | %7.1f MB/s | x%5.2f | %d vars, %d clauses\n",
+               path_names[path], best, copy.size() / 1048576.0 / best, base / best, vars, clauses);
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+/**************************************************************************************[BinaryCnf.h]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_BinaryCnf_h
+#define Minisat_BinaryCnf_h
+
+#include <stdio.h>
+#include <string.h>
+
+#include "minisat/utils/ParseUtils.h"
+#include "minisat/core/SolverTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Binary CNF format:
+//
+// A header, the size of every clause, and then the literals of all clauses one after the other.
+// Literals are stored as 'toInt(Lit)' (that is '2*var + sign'), so loading needs no conversion. All
+// fields are in the byte order of the machine that wrote the file (a mismatch shows in 'version').
+//
+//   header   : 'BinaryCnfHeader' (32 bytes)
+//   sizes    : 'clauses' x uint32
+//   literals : 'lits' x uint32 (the sum of the sizes)
+//
+// Files are written by 'Solver::toBinary()', and loaded with 'Solver::addClauses()'.
+
+struct BinaryCnfHeader {
+    char     magic[8];   // "MSATBCNF"
+    uint32_t version;
+    uint32_t vars;
+    uint64_t clauses;
+    uint64_t lits;
+};
+
+enum { binary_cnf_version = 1 };
+
+static inline bool isBinaryCNF(const char* data, size_t size) {
+    return size >= 8 && memcmp(data, "MSATBCNF", 8) == 0; }
+
+static inline void binaryError(const char* msg) {
+    printf("PARSE ERROR! %s\n", msg), exit(3); }
+
+// Inserts the problem in the binary CNF in 'data' (of 'size' bytes, aligned to 4 bytes) into solver.
+//
+template<class Solver>
+static void parse_BinaryCNF(const char* data, size_t size, Solver& S) {
+    BinaryCnfHeader h;
+    if (size < sizeof(h) || !isBinaryCNF(data, size))
+        binaryError("Not a binary CNF file.");
+    memcpy(&h, data, sizeof(h));
+    if (h.version != binary_cnf_version)
+        binaryError("Unsupported binary CNF version (or byte order).");
+    if (((uintptr_t)data & 3) != 0)
+        binaryError("Binary CNF data is not aligned.");
+
+    size_t words = (size - sizeof(h)) / sizeof(uint32_t);
+    if (h.clauses > words || h.lits != words - h.clauses || (size - sizeof(h)) % sizeof(uint32_t) != 0)
+        binaryError("Binary CNF file has the wrong size.");
+    if (h.vars > (uint32_t)INT32_MAX / 2)
+        binaryError("Too many variables in binary CNF file.");
+
+    const uint32_t* sizes = (const uint32_t*)(data + sizeof(h));
+    const uint32_t* lits  = sizes + h.clauses;
+
+    // Check the clause sizes and the literals before using them:
+    uint64_t n_lits = 0;
+    for (uint64_t i = 0; i < h.clauses; i++)
+        n_lits += sizes[i];
+    if (n_lits != h.lits)
+        binaryError("Binary CNF clause sizes do not add up to the number of literals.");
+    for (uint64_t i = 0; i < h.lits; i++)
+        if (lits[i] >= 2 * h.vars)
+            binaryError("Binary CNF literal out of range.");
+
+    while (S.nVars() < (int)h.vars) S.newVar();
+    S.addClauses(sizes, lits, h.clauses);
+}
+
+template<class Solver>
+static void parse_BinaryCNF(const MappedFile& input, Solver& S) {
+    parse_BinaryCNF(input.data(), input.size(), S); }
+
+//=================================================================================================
+}
+
+#endif
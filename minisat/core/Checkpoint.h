@@ -0,0 +1,83 @@
+/*************************************************************************************[Checkpoint.h]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_Checkpoint_h
+#define Minisat_Checkpoint_h
+
+#include <stdio.h>
+
+#include "minisat/mtl/Vec.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Checkpoint files -- the state of a solver, written by 'Solver::checkpoint()':
+//
+// The magic "MSATCKPT", the version and the size of clause references, followed by the state of
+// each solver class in turn ('Solver::saveState()' and its overrides). Values are stored in the
+// byte order of the machine, so a checkpoint is restored by a build for the same platform.
+
+enum { checkpoint_version = 1 };
+
+
+class CheckpointWriter {
+    FILE* f;
+public:
+    explicit CheckpointWriter(FILE* out) : f(out) {}
+
+    template<class T>
+    void put(const T& x)        { fwrite(&x, sizeof(T), 1, f); }
+    template<class T>
+    void put(const vec<T>& xs)  { put((int)xs.size()); put(&xs[0], xs.size()); }
+    template<class T>
+    void put(const T* xs, uint64_t n){ if (n > 0) fwrite(xs, sizeof(T), (size_t)n, f); }
+
+    bool ok() const { return !ferror(f); }
+};
+
+
+// Reading stops at the first error. Vectors read are limited to 'max_size' elements, so that a
+// corrupt size can not exhaust the memory.
+class CheckpointReader {
+    FILE* f;
+    bool  ok_;
+public:
+    explicit CheckpointReader(FILE* in) : f(in), ok_(true) {}
+
+    template<class T>
+    bool get(T& x)              { return ok_ = ok_ && fread(&x, sizeof(T), 1, f) == 1; }
+    template<class T>
+    bool get(vec<T>& xs, int max_size = INT32_MAX){
+        int n;
+        if (!get(n) || n < 0 || n > max_size) return ok_ = false;
+        xs.clear();
+        xs.growTo(n);
+        return get((T*)xs, n); }
+    template<class T>
+    bool get(T* xs, uint64_t n) { return ok_ = ok_ && (n == 0 || fread(xs, sizeof(T), (size_t)n, f) == (size_t)n); }
+
+    bool fail()                 { return ok_ = false; }
+    bool ok() const             { return ok_; }
+};
+
+//=================================================================================================
+}
+
+#endif
@@ -0,0 +1,163 @@
+/****************************************************************************************[Dimacs.cc]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <string.h>
+
+#include "minisat/core/Dimacs.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Tokenizer:
+
+
+// As 'parseInt()', but an unexpected character is stored in 'out' rather than reported.
+static bool tokenInt(MemBuffer& in, vec<int>& out)
+{
+    int     val = 0;
+    bool    neg = false;
+    skipWhitespace(in);
+    if      (*in == '-') neg = true, ++in;
+    else if (*in == '+') ++in;
+    if (*in < '0' || *in > '9'){
+        out.push(tok_BadChar);
+        out.push(*in);
+        return false; }
+    while (*in >= '0' && *in <= '9')
+        val = val*10 + (*in - '0'),
+        ++in;
+    out.push(neg ? -val : val);
+    return true;
+}
+
+
+// Tokenize a piece of a DIMACS file. It must start at the beginning of a line, and end at the end
+// of one. Comments and headers are kept as markers, since they are errors inside a clause (which
+// may have started in an earlier piece).
+void Minisat::tokenize_DIMACS(const char* begin, const char* end, vec<int>& out)
+{
+    MemBuffer in(begin, end);
+    for (;;){
+        skipWhitespace(in);
+        if (*in == EOF) break;
+        else if (*in == 'c'){
+            out.push(tok_Comment);
+            skipLine(in);
+        }else if (*in == 'p'){
+            if (!eagerMatch(in, "p cnf")){
+                out.push(tok_BadHeader);
+                out.push(*in);
+                break; }
+            out.push(tok_Header);   // (the two fields that follow may be in the next piece)
+        }else if (!tokenInt(in, out))
+            break;
+    }
+}
+
+
+//=================================================================================================
+// DimacsChunks:
+
+
+DimacsChunks::DimacsChunks(const char* d, size_t size, int n_threads) :
+    data(d), next(0), released(0), stop(false)
+{
+    // Split at the first line break after every 'chunk_size' bytes:
+    bounds.push(0);
+    for (size_t p = chunk_size; p < size; ){
+        const char* nl = (const char*)memchr(data + p, '\n', size - p);
+        if (nl == NULL || (size_t)(nl - data) + 1 >= size) break;
+        bounds.push(nl - data + 1);
+        p = bounds.last() + chunk_size;
+    }
+    bounds.push(size);
+
+    tokens.growTo(this->size());
+    ready .growTo(this->size(), 0);
+
+    if (n_threads < 1) n_threads = 1;
+    window = 4 * n_threads;
+    for (int i = 0; i < n_threads && i < this->size(); i++)
+        threads.push(new std::thread(&DimacsChunks::work, this));
+}
+
+
+DimacsChunks::~DimacsChunks()
+{
+    {
+        std::lock_guard<std::mutex> l(lock);
+        stop = true;
+    }
+    cond.notify_all();
+    for (int i = 0; i < threads.size(); i++){
+        threads[i]->join();
+        delete threads[i]; }
+}
+
+
+void DimacsChunks::work()
+{
+    for (;;){
+        int i;
+        {
+            std::unique_lock<std::mutex> l(lock);
+            while (!stop && next < size() && next >= released + window)
+                cond.wait(l);
+            if (stop || next >= size()) return;
+            i = next++;
+        }
+
+        char result = 1;
+        try {
+            tokenize_DIMACS(data + bounds[i], data + bounds[i+1], tokens[i]);
+        } catch (OutOfMemoryException&){
+            tokens[i].clear(true);
+            result = 2;
+        }
+
+        {
+            std::lock_guard<std::mutex> l(lock);
+            ready[i] = result;
+        }
+        cond.notify_all();
+    }
+}
+
+
+const vec<int>& DimacsChunks::get(int i)
+{
+    std::unique_lock<std::mutex> l(lock);
+    while (ready[i] == 0)
+        cond.wait(l);
+    if (ready[i] == 2)
+        throw OutOfMemoryException();
+    return tokens[i];
+}
+
+
+void DimacsChunks::release(int i)
+{
+    tokens[i].clear(true);
+    {
+        std::lock_guard<std::mutex> l(lock);
+        released = i + 1;
+    }
+    cond.notify_all();
+}
@@ -22,6 +22,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define Minisat_Dimacs_h
 
 #include <stdio.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include "minisat/utils/ParseUtils.h"
 #include "minisat/core/SolverTypes.h"
@@ -81,6 +84,113 @@ static void parse_DIMACS(gzFile input_stream, Solver& S, bool strictp = false) {
     StreamBuffer in(input_stream);
     parse_DIMACS_main(in, S, strictp); }
 
+//=================================================================================================
+// Parallel DIMACS Parser (for uncompressed files):
+//
+// The file is split into chunks at line breaks. Threads turn the chunks into tokens, which are
+// inserted into the solver in file order, with the same checks (and errors) as the serial parser.
+
+
+// Besides the integers of the file, a token list holds these markers. The last two stop the list,
+// and are followed by the unexpected character.
+enum { tok_Comment = INT32_MIN, tok_Header, tok_BadHeader, tok_BadChar };
+
+void tokenize_DIMACS(const char* begin, const char* end, vec<int>& out);
+
+
+class DimacsChunks {
+    const char*             data;
+    vec<size_t>             bounds;       // Chunk 'i' is 'data[bounds[i]]' to 'data[bounds[i+1]]'.
+    vec<vec<int> >          tokens;
+    vec<char>               ready;        // (0 = not tokenized, 1 = tokenized, 2 = out of memory)
+    int                     next;         // The next chunk to tokenize.
+    int                     released;     // The chunks before this one have been inserted.
+    int                     window;       // Limit on the chunks tokenized ahead of 'released'.
+    bool                    stop;
+    std::mutex              lock;         // Guards 'ready', 'next', 'released' and 'stop'.
+    std::condition_variable cond;
+    vec<std::thread*>       threads;
+
+    void work();
+
+public:
+    enum { chunk_size = 4*1024*1024 };
+
+    DimacsChunks(const char* data, size_t size, int n_threads);
+    ~DimacsChunks();
+
+    int             size   () const { return bounds.size() - 1; }
+    const vec<int>& get    (int i);       // Wait for the tokens of chunk 'i'.
+    void            release(int i);       // Free the tokens of chunk 'i' (and all before it).
+};
+
+
+static inline void parseError(int c) {
+    fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", c), exit(3); }
+
+template<class Solver>
+static void parse_DIMACS_chunks(DimacsChunks& in, Solver& S, bool strictp = false) {
+    vec<Lit> lits;
+    int  clauses = 0;
+    int  cnt     = 0;
+    int  header  = 0;     // Number of header fields still to read.
+    bool open    = false; // In the middle of a clause.
+    for (int i = 0; i < in.size(); i++){
+        const vec<int>& toks = in.get(i);
+        for (int k = 0; k < toks.size(); k++){
+            int t = toks[k];
+            if (t == tok_Comment || t == tok_Header){
+                if (open || header > 0) parseError(t == tok_Comment ? 'c' : 'p');
+                if (t == tok_Header) header = 2;
+            }else if (t == tok_BadHeader){
+                if (open || header > 0) parseError('p');
+                printf("PARSE ERROR! Unexpected char: %c\n", toks[k+1]), exit(3);
+            }else if (t == tok_BadChar)
+                parseError(toks[k+1]);
+            else if (header == 2)
+                header--;         // (the number of variables is not needed)
+            else if (header == 1)
+                clauses = t, header--;
+            else{
+                if (!open){
+                    cnt++;
+                    lits.clear();
+                    open = true; }
+                if (t == 0){
+                    S.addClause_(lits);
+                    open = false;
+                }else{
+                    int var = abs(t)-1;
+                    while (var >= S.nVars()) S.newVar();
+                    lits.push( (t > 0) ? mkLit(var) : ~mkLit(var) );
+                }
+            }
+        }
+        in.release(i);
+    }
+    if (open || header > 0) parseError(EOF);
+    if (strictp && cnt != clauses)
+        printf("PARSE ERROR! DIMACS header mismatch: wrong number of clauses\n");
+}
+
+// Inserts the problem in the memory block 'data' of 'size' bytes (it need not end with '\0') into
+// solver. With more than one thread, it is tokenized in parallel chunks.
+//
+template<class Solver>
+static void parse_DIMACS(const char* data, size_t size, Solver& S, bool strictp = false, int n_threads = 1) {
+    if (n_threads <= 1){
+        MemBuffer in(data, data + size);
+        parse_DIMACS_main(in, S, strictp);
+    }else{
+        DimacsChunks in(data, size, n_threads);
+        parse_DIMACS_chunks(in, S, strictp); } }
+
+// Inserts the problem in the (uncompressed) file 'input' into solver.
+//
+template<class Solver>
+static void parse_DIMACS(const MappedFile& input, Solver& S, bool strictp = false, int n_threads = 1) {
+    parse_DIMACS(input.data(), input.size(), S, strictp, n_threads); }
+
 //=================================================================================================
 }
 
@@ -20,11 +20,13 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include <errno.h>
 #include <zlib.h>
+#include <thread>
 
 #include "minisat/utils/System.h"
 #include "minisat/utils/ParseUtils.h"
 #include "minisat/utils/Options.h"
 #include "minisat/core/Dimacs.h"
+#include "minisat/core/BinaryCnf.h"
 #include "minisat/core/Solver.h"
 
 using namespace Minisat;
@@ -55,7 +57,7 @@ static void SIGINT_exit(int) {
 int main(int argc, char** argv)
 {
     try {
-        setUsageHelp("USAGE: %s [options] <input-file> <result-output-file>\n\n  where input may be either in plain or gzipped DIMACS.\n");
+        setUsageHelp("USAGE: %s [options] <input-file> <result-output-file>\n\n  where input may be either in plain or gzipped DIMACS, or in binary CNF.\n");
         setX86FPUPrecision();
 
         // Extra options:
@@ -64,6 +66,10 @@ int main(int argc, char** argv)
         IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds.\n", 0, IntRange(0, INT32_MAX));
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", 0, IntRange(0, INT32_MAX));
         BoolOption   strictp("MAIN", "strict", "Validate DIMACS header during parsing.", false);
+        IntOption    parse_threads("MAIN", "parse-threads", "Number of threads parsing an uncompressed input file, which is mapped into memory (0 = one per hardware thread, -1 = read it through zlib).", 0, IntRange(-1, 1024));
+        StringOption checkpoint("MAIN", "checkpoint", "Write the solver state to this file periodically during search, and when interrupted.");
+        IntOption    ckpt_int("MAIN", "ckpt-interval", "Wall-clock seconds between two checkpoints.", 600, IntRange(1, INT32_MAX));
+        BoolOption   resume ("MAIN", "resume", "If the checkpoint file exists, continue from it instead of reading the input.", false);
         
         parseOptions(argc, argv, true);
 
@@ -84,16 +90,38 @@ int main(int argc, char** argv)
         if (argc == 1)
             printf("Reading from standard input... Use '--help' for help.\n");
         
-        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
-        if (in == NULL)
+        // A run with an existing checkpoint continues from it (and does not read the input):
+        FILE* ckpt     = resume && checkpoint != NULL ? fopen((const char*)checkpoint, "rb") : NULL;
+        bool  resuming = ckpt != NULL;
+        if (ckpt != NULL) fclose(ckpt);
+
+        // Uncompressed files are mapped into memory (and parsed in parallel chunks on several threads).
+        // Binary CNF files are always read this way:
+        MappedFile mapped;
+        bool       use_mmap = !resuming && argc > 1 && mapped.open(argv[1]) && !mapped.isGzip()
+                           && (parse_threads >= 0 || isBinaryCNF(mapped.data(), mapped.size()));
+        gzFile     in       = resuming || use_mmap ? NULL : (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
+        if (!resuming && !use_mmap && in == NULL)
             printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
         
         if (S.verbosity > 0){
             printf("============================[ Problem Statistics ]=============================\n");
             printf("|                                                                             |\n"); }
         
-        parse_DIMACS(in, S, (bool)strictp);
-        gzclose(in);
+        if (resuming){
+            if (!S.restore((const char*)checkpoint))
+                printf("ERROR! Could not restore checkpoint: %s\n", (const char*)checkpoint), exit(1);
+            if (S.verbosity > 0)
+                printf("|  Resumed from checkpoint after %12" PRIu64 " conflicts                       |\n", S.conflicts);
+        }else if (use_mmap && isBinaryCNF(mapped.data(), mapped.size())){
+            parse_BinaryCNF(mapped, S);
+            mapped.close();
+        }else if (use_mmap){
+            parse_DIMACS(mapped, S, (bool)strictp, parse_threads != 0 ? (int)parse_threads : (int)std::thread::hardware_concurrency());
+            mapped.close();
+        }else{
+            parse_DIMACS(in, S, (bool)strictp);
+            gzclose(in); }
         FILE* res = (argc >= 3) ? fopen(argv[2], "wb") : NULL;
         
         if (S.verbosity > 0){
@@ -108,6 +136,10 @@ int main(int argc, char** argv)
         // Change to signal-handlers that will only notify the solver and allow it to terminate
         // voluntarily:
         sigTerm(SIGINT_interrupt);
+
+        if (checkpoint != NULL){
+            S.checkpoint_file     = (const char*)checkpoint;
+            S.checkpoint_interval = ckpt_int; }
        
         if (!S.simplify()){
             if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
@@ -122,6 +154,8 @@ int main(int argc, char** argv)
         
         vec<Lit> dummy;
         lbool ret = S.solveLimited(dummy);
+        if (ret == l_Undef && checkpoint != NULL && !S.checkpoint((const char*)checkpoint))
+            fprintf(stderr, "WARNING! Could not write checkpoint to %s\n", (const char*)checkpoint);
         if (S.verbosity > 0){
             S.printStats();
             printf("\n"); }
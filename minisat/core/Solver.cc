@@ -24,9 +24,16 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "minisat/mtl/Sort.h"
 #include "minisat/utils/System.h"
 #include "minisat/core/Solver.h"
+#include "minisat/core/BinaryCnf.h"
 
 using namespace Minisat;
 
+// Number of watchers ahead of the current one whose clauses are prefetched in 'propagate()'.
+// Set to 0 to disable prefetching:
+#ifndef MINISAT_PREFETCH_DISTANCE
+#define MINISAT_PREFETCH_DISTANCE 8
+#endif
+
 //=================================================================================================
 // Options:
 
@@ -37,14 +44,26 @@ static DoubleOption  opt_var_decay         (_cat, "var-decay",   "The variable a
 static DoubleOption  opt_clause_decay      (_cat, "cla-decay",   "The clause activity decay factor",              0.999,    DoubleRange(0, false, 1, false));
 static DoubleOption  opt_random_var_freq   (_cat, "rnd-freq",    "The frequency with which the decision heuristic tries to choose a random variable", 0, DoubleRange(0, true, 1, true));
 static DoubleOption  opt_random_seed       (_cat, "rnd-seed",    "Used by the random variable selection",         91648253, DoubleRange(0, false, HUGE_VAL, false));
-static IntOption     opt_ccmin_mode        (_cat, "ccmin-mode",  "Controls conflict clause minimization (0=none, 1=basic, 2=deep)", 2, IntRange(0, 2));
+static IntOption     opt_ccmin_mode        (_cat, "ccmin-mode",  "Controls conflict clause minimization (0=none, 1=basic, 2=deep, 3=deep+binary)", 2, IntRange(0, 3));
 static IntOption     opt_phase_saving      (_cat, "phase-saving", "Controls the level of phase saving (0=none, 1=limited, 2=full)", 2, IntRange(0, 2));
 static BoolOption    opt_rnd_init_act      (_cat, "rnd-init",    "Randomize the initial activity", false);
+static BoolOption    opt_vmtf              (_cat, "vmtf",        "Use a variable-move-to-front queue instead of VSIDS for decisions", false);
 static BoolOption    opt_luby_restart      (_cat, "luby",        "Use the Luby restart sequence", true);
+static BoolOption    opt_ema_restart       (_cat, "ema-restart", "Use dynamic restarts based on moving averages of the LBD (instead of -luby)", false);
+static DoubleOption  opt_restart_margin    (_cat, "restart-margin", "(ema) Restart if the recent average LBD exceeds the long term one by this factor", 1.25, DoubleRange(0, false, HUGE_VAL, false));
+static DoubleOption  opt_restart_block     (_cat, "restart-block",  "(ema) Block restarts if the trail exceeds its recent average by this factor (0 = never)", 1.4, DoubleRange(0, true, HUGE_VAL, false));
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 100, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
 static IntOption     opt_min_learnts_lim   (_cat, "min-learnts", "Minimum learnt clause limit",  0, IntRange(0, INT32_MAX));
+static IntOption     opt_core_lbd          (_cat, "core-lbd",    "Never remove learnt clauses with an LBD up to this value", 2, IntRange(0, Clause::LBD_Max-1));
+static IntOption     opt_tier2_lbd         (_cat, "tier2-lbd",   "Keep learnt clauses with an LBD up to this value while they are used", 6, IntRange(0, Clause::LBD_Max-1));
+static IntOption     opt_chrono            (_cat, "chrono",      "Backtrack chronologically if a backjump would skip more than this many levels (-1 = never)", -1, IntRange(-1, INT32_MAX));
+static IntOption     opt_confl_to_chrono   (_cat, "confl-to-chrono", "Number of conflicts before chronological backtracking is allowed", 4000, IntRange(0, INT32_MAX));
+static DoubleOption  opt_vivify_eff        (_cat, "vivify-eff",  "Propagations spent on vivifying learnt clauses, relative to those of the search (0 = off)", 0, DoubleRange(0, true, HUGE_VAL, false));
+static IntOption     opt_vivify_interval   (_cat, "vivify-int",  "Number of conflicts between rounds of learnt clause vivification", 2000, IntRange(1, INT32_MAX));
+static DoubleOption  opt_probe_eff         (_cat, "probe-eff",   "Propagations spent on failed literal probing, relative to those of the search (0 = off)", 0.05, DoubleRange(0, true, HUGE_VAL, false));
+static IntOption     opt_probe_interval    (_cat, "probe-int",   "Number of conflicts between rounds of failed literal probing", 5000, IntRange(1, INT32_MAX));
 
 
 //=================================================================================================
@@ -61,12 +80,27 @@ Solver::Solver() :
   , random_var_freq  (opt_random_var_freq)
   , random_seed      (opt_random_seed)
   , luby_restart     (opt_luby_restart)
+  , ema_restart      (opt_ema_restart)
+  , restart_margin   (opt_restart_margin)
+  , restart_block    (opt_restart_block)
+  , restart_policy   (NULL)
   , ccmin_mode       (opt_ccmin_mode)
   , phase_saving     (opt_phase_saving)
   , rnd_pol          (false)
   , rnd_init_act     (opt_rnd_init_act)
+  , vmtf             (opt_vmtf)
   , garbage_frac     (opt_garbage_frac)
   , min_learnts_lim  (opt_min_learnts_lim)
+  , core_lbd         (opt_core_lbd)
+  , tier2_lbd        (opt_tier2_lbd)
+  , chrono           (opt_chrono)
+  , confl_to_chrono  (opt_confl_to_chrono)
+  , vivify_eff       (opt_vivify_eff)
+  , vivify_interval  (opt_vivify_interval)
+  , probe_eff        (opt_probe_eff)
+  , probe_interval   (opt_probe_interval)
+  , checkpoint_file  (NULL)
+  , checkpoint_interval(600)
   , restart_first    (opt_restart_first)
   , restart_inc      (opt_restart_inc)
 
@@ -83,18 +117,31 @@ Solver::Solver() :
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0)
   , dec_vars(0), num_clauses(0), num_learnts(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , chrono_backtracks(0), bin_min_literals(0), vivified_clauses(0), vivified_literals(0)
+  , probed_literals(0), failed_literals(0), hyper_binaries(0)
 
+  , learnts_core       (0)
   , watches            (WatcherDeleted(ca))
-  , order_heap         (VarOrderLt(activity))
+  , watches_bin        (WatcherDeleted(ca))
+  , watches_tern       (WatcherDeleted(ca))
+  , vmtf_order         (assigns, decision)
+  , order              (vmtf ? (DecisionHeuristic*)&vmtf_order : &vsids)
   , ok                 (true)
   , cla_inc            (1)
-  , var_inc            (1)
   , qhead              (0)
   , simpDB_assigns     (-1)
   , simpDB_props       (0)
+  , next_vivify        (0)
+  , vivify_props       (0)
+  , next_probe         (0)
+  , probe_props        (0)
+  , probe_next         (0)
   , progress_estimate  (0)
+  , next_checkpoint    (0)
+  , restored           (false)
   , remove_satisfied   (true)
   , next_var           (0)
+  , lbd_counter        (0)
 
     // Resource constraints:
     //
@@ -127,10 +174,14 @@ Var Solver::newVar(lbool upol, bool dvar)
 
     watches  .init(mkLit(v, false));
     watches  .init(mkLit(v, true ));
-    assigns  .insert(v, l_Undef);
+    watches_bin.init(mkLit(v, false));
+    watches_bin.init(mkLit(v, true ));
+    watches_tern.init(mkLit(v, false));
+    watches_tern.init(mkLit(v, true ));
+    assigns  .insert(v);
     vardata  .insert(v, mkVarData(CRef_Undef, 0));
-    activity .insert(v, rnd_init_act ? drand(random_seed) * 0.00001 : 0);
-    seen     .insert(v, 0);
+    vsids    .newVar(v, rnd_init_act ? drand(random_seed) * 0.00001 : 0);
+    vmtf_order.newVar(v);
     polarity .insert(v, true);
     user_pol .insert(v, upol);
     decision .reserve(v);
@@ -181,11 +232,95 @@ bool Solver::addClause_(vec<Lit>& ps)
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  addClauses : (sizes : const uint32_t*) (lits : const uint32_t*) (n_clauses : uint64_t)  ->  [bool]
+|
+|  Description:
+|    Add 'n_clauses' problem clauses at once. Clause 'i' has 'sizes[i]' literals, taken in turn from
+|    'lits' in the encoding of 'toInt()'; the variables must already exist. Room for all clauses and
+|    their watchers is reserved up front. Clauses of distinct unassigned variables (all of them, in a
+|    file written by 'toBinary()') go straight to the clause allocator, and are attached afterwards.
+|    The rest go through 'addClause_()'. Must be called at decision level 0. Returns FALSE if the
+|    solver became contradictory.
+|________________________________________________________________________________________________@*/
+bool Solver::addClauses(const uint32_t* sizes, const uint32_t* lits, uint64_t n_clauses)
+{
+    assert(decisionLevel() == 0);
+    if (!ok) return false;
+
+    // Count the watchers of every literal, and reserve room for them and for the clauses:
+    vec<int>        n_watch(2*nVars(), 0), n_bin(2*nVars(), 0), n_tern(2*nVars(), 0);
+    uint64_t        n_lits = 0;
+    const uint32_t* p      = lits;
+    for (uint64_t i = 0; i < n_clauses; p += sizes[i++]){
+        n_lits += sizes[i];
+        if (sizes[i] == 3)
+            n_tern[p[0] ^ 1]++, n_tern[p[1] ^ 1]++, n_tern[p[2] ^ 1]++;
+        else if (sizes[i] >= 2){
+            vec<int>& n = sizes[i] == 2 ? n_bin : n_watch;
+            n[p[0] ^ 1]++, n[p[1] ^ 1]++; }
+    }
+    for (int i = 0; i < 2*nVars(); i++){
+        Lit l = toLit(i);
+        if (n_watch[i] > 0) watches    [l].capacity(watches    [l].size() + n_watch[i]);
+        if (n_bin  [i] > 0) watches_bin[l].capacity(watches_bin[l].size() + n_bin  [i]);
+        if (n_tern [i] > 0) watches_tern[l].capacity(watches_tern[l].size() + n_tern[i]);
+    }
+    if ((uint64_t)clauses.size() + n_clauses <= (uint64_t)INT32_MAX)
+        clauses.capacity(clauses.size() + (int)n_clauses);
+    ca.reserve(n_clauses, n_lits);
+
+    vec<Lit>& ps       = add_tmp;
+    vec<char> mark(nVars(), 0);
+    int       attached = clauses.size();
+    p = lits;
+    for (uint64_t i = 0; i < n_clauses; p += sizes[i++]){
+        bool direct = sizes[i] >= 2;
+        ps.clear();
+        for (uint32_t k = 0; k < sizes[i]; k++){
+            Lit l = toLit(p[k]);
+            if (mark[var(l)] || value(l) != l_Undef)
+                direct = false;
+            mark[var(l)] = 1;
+            ps.push(l);
+        }
+        for (int k = 0; k < ps.size(); k++)
+            mark[var(ps[k])] = 0;
+
+        if (direct)
+            clauses.push(ca.alloc(ps, false));
+        else{
+            // (propagating units needs the clauses so far attached)
+            for (; attached < clauses.size(); attached++)
+                attachClause(clauses[attached]);
+            if (!addClause_(ps))
+                return false;
+            attached = clauses.size();
+        }
+    }
+
+    // Attaching the clauses after allocating them all, rather than in turn, keeps the clause
+    // memory and the watcher lists from competing for the cache:
+    for (; attached < clauses.size(); attached++)
+        attachClause(clauses[attached]);
+
+    return ok;
+}
+
+
 void Solver::attachClause(CRef cr){
     const Clause& c = ca[cr];
     assert(c.size() > 1);
-    watches[~c[0]].push(Watcher(cr, c[1]));
-    watches[~c[1]].push(Watcher(cr, c[0]));
+    if (c.size() == 3){
+        watches_tern[~c[0]].push(TernaryWatcher(cr, c[1], c[2]));
+        watches_tern[~c[1]].push(TernaryWatcher(cr, c[0], c[2]));
+        watches_tern[~c[2]].push(TernaryWatcher(cr, c[0], c[1]));
+    }else{
+        OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>& ws = c.size() == 2 ? watches_bin : watches;
+        ws[~c[0]].push(Watcher(cr, c[1]));
+        ws[~c[1]].push(Watcher(cr, c[0]));
+    }
     if (c.learnt()) num_learnts++, learnts_literals += c.size();
     else            num_clauses++, clauses_literals += c.size();
 }
@@ -196,12 +331,22 @@ void Solver::detachClause(CRef cr, bool strict){
     assert(c.size() > 1);
     
     // Strict or lazy detaching:
-    if (strict){
-        remove(watches[~c[0]], Watcher(cr, c[1]));
-        remove(watches[~c[1]], Watcher(cr, c[0]));
+    if (c.size() == 3){
+        TernaryWatcher w(cr, lit_Undef, lit_Undef);
+        for (int k = 0; k < 3; k++)
+            if (strict)
+                remove(watches_tern[~c[k]], w);
+            else
+                watches_tern.smudge(~c[k]);
     }else{
-        watches.smudge(~c[0]);
-        watches.smudge(~c[1]);
+        OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>& ws = c.size() == 2 ? watches_bin : watches;
+        if (strict){
+            remove(ws[~c[0]], Watcher(cr, c[1]));
+            remove(ws[~c[1]], Watcher(cr, c[0]));
+        }else{
+            ws.smudge(~c[0]);
+            ws.smudge(~c[1]);
+        }
     }
 
     if (c.learnt()) num_learnts--, learnts_literals -= c.size();
@@ -213,7 +358,7 @@ void Solver::removeClause(CRef cr) {
     Clause& c = ca[cr];
     detachClause(cr);
     // Don't leave pointers to free'd memory!
-    if (locked(c)) vardata[var(c[0])].reason = CRef_Undef;
+    if (locked(c)) vardata[var(c[0])].reason.cref = CRef_Undef;
     c.mark(1); 
     ca.free(cr);
 }
@@ -228,17 +373,26 @@ bool Solver::satisfied(const Clause& c) const {
 
 // Revert to the state at given level (keeping all assignment at 'level' but not beyond).
 //
+// NOTE: after chronological backtracking, the trail may hold literals of lower levels above
+// 'trail_lim[level]'. These are kept, in the same order, and queued for propagation again.
+//
 void Solver::cancelUntil(int level) {
     if (decisionLevel() > level){
+        cancel_keep.clear();
         for (int c = trail.size()-1; c >= trail_lim[level]; c--){
             Var      x  = var(trail[c]);
-            assigns [x] = l_Undef;
+            if (this->level(x) <= level){
+                cancel_keep.push(trail[c]);
+                continue; }
+            assigns .unassign(x);
             if (phase_saving > 1 || (phase_saving == 1 && c > trail_lim.last()))
                 polarity[x] = sign(trail[c]);
             insertVarOrder(x); }
         qhead = trail_lim[level];
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
+        for (int c = cancel_keep.size()-1; c >= 0; c--)
+            trail.push_(cancel_keep[c]);
     } }
 
 
@@ -251,18 +405,18 @@ Lit Solver::pickBranchLit()
     Var next = var_Undef;
 
     // Random decision:
-    if (drand(random_seed) < random_var_freq && !order_heap.empty()){
-        next = order_heap[irand(random_seed,order_heap.size())];
+    if (drand(random_seed) < random_var_freq && !order->empty()){
+        next = order->random(drand(random_seed));
         if (value(next) == l_Undef && decision[next])
             rnd_decisions++; }
 
-    // Activity based decision:
+    // Activity (or most recently bumped) based decision:
     while (next == var_Undef || value(next) != l_Undef || !decision[next])
-        if (order_heap.empty()){
+        if (order->empty()){
             next = var_Undef;
             break;
         }else
-            next = order_heap.removeMin();
+            next = order->removeMin();
 
     // Choose polarity based on different polarity modes (global or per-variable):
     if (next == var_Undef)
@@ -276,6 +430,50 @@ Lit Solver::pickBranchLit()
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  conflictLevel : (confl : CRef) (single : bool&)  ->  [int]
+|  
+|  Description:
+|    Returns the highest level among the literals of the conflicting clause 'confl'. Without
+|    chronological backtracking this is always the current decision level. A literal of that level
+|    is moved to 'confl[0]' (keeping the watchers consistent) and 'single' tells if it is the only one,
+|    in which case the clause is unit on the level below.
+|________________________________________________________________________________________________@*/
+int Solver::conflictLevel(CRef confl, bool& single)
+{
+    Clause& c         = ca[confl];
+    int     max_level = level(var(c[0]));
+    int     max_k     = 0;
+    single = false;
+    if (max_level == decisionLevel() && level(var(c[1])) == decisionLevel())
+        return max_level;
+
+    single = true;
+    for (int k = 1; k < c.size(); k++){
+        int l = level(var(c[k]));
+        if (l > max_level){
+            max_k     = k;
+            max_level = l;
+            single    = true;
+        }else if (l == max_level)
+            single    = false;
+    }
+
+    if (max_k != 0){
+        Lit tmp = c[0]; c[0] = c[max_k]; c[max_k] = tmp;
+
+        // Only clauses larger than ternary depend on the position of their watched literals:
+        if (max_k > 1 && c.size() > 3){
+            remove(watches[~c[max_k]], Watcher(confl, c[1]));
+            watches[~c[0]].push(Watcher(confl, c[1]));
+        }
+    }
+
+    return max_level;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  analyze : (confl : Clause*) (out_learnt : vec<Lit>&) (out_btlevel : int&)  ->  [void]
@@ -304,18 +502,34 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
     int index   = trail.size() - 1;
 
     do{
-        assert(confl != CRef_Undef); // (otherwise should be UIP)
-        Clause& c = ca[confl];
-
-        if (c.learnt())
-            claBumpActivity(c);
+        // Binary reasons are stored inline and do not need to be looked up in the clause arena:
+        const Lit* c;
+        int        size;
+        Lit        bin[2];
+        if (confl != CRef_Undef){
+            Clause& cl = ca[confl];
+            if (cl.learnt()){
+                claBumpActivity(cl);
+
+                // Clauses taking part in a conflict may turn out to have a smaller LBD by now:
+                cl.used(true);
+                if (cl.lbd() > core_lbd){
+                    int lbd = computeLBD(cl);
+                    if (lbd < cl.lbd())
+                        cl.lbd(lbd);
+                }
+            }
+            c    = cl;
+            size = cl.size();
+        }else
+            c = reasonLits(var(p), bin, size);   // (otherwise should be UIP)
 
-        for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
+        for (int j = (p == lit_Undef) ? 0 : 1; j < size; j++){
             Lit q = c[j];
 
-            if (!seen[var(q)] && level(var(q)) > 0){
-                varBumpActivity(var(q));
-                seen[var(q)] = 1;
+            if (!seen(var(q)) && level(var(q)) > 0){
+                order->bump(var(q));
+                setSeen(var(q), 1);
                 if (level(var(q)) >= decisionLevel())
                     pathC++;
                 else
@@ -323,11 +537,14 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
             }
         }
         
-        // Select next clause to look at:
-        while (!seen[var(trail[index--])]);
-        p     = trail[index+1];
+        // Select next clause to look at (after chronological backtracking, literals from lower
+        // levels may appear among those of the current level and are skipped):
+        do{
+            while (!seen(var(trail[index--])));
+            p = trail[index+1];
+        }while (level(var(p)) < decisionLevel());
         confl = reason(var(p));
-        seen[var(p)] = 0;
+        setSeen(var(p), 0);
         pathC--;
 
     }while (pathC > 0);
@@ -337,21 +554,26 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
     //
     int i, j;
     out_learnt.copyTo(analyze_toclear);
-    if (ccmin_mode == 2){
+    if (ccmin_mode >= 2){
         for (i = j = 1; i < out_learnt.size(); i++)
-            if (reason(var(out_learnt[i])) == CRef_Undef || !litRedundant(out_learnt[i]))
+            if (!hasReason(var(out_learnt[i])) || !litRedundant(out_learnt[i]))
                 out_learnt[j++] = out_learnt[i];
+
+        if (ccmin_mode == 3 && j > 1)
+            binaryMinimize(out_learnt, j);
         
     }else if (ccmin_mode == 1){
         for (i = j = 1; i < out_learnt.size(); i++){
             Var x = var(out_learnt[i]);
 
-            if (reason(x) == CRef_Undef)
+            if (!hasReason(x))
                 out_learnt[j++] = out_learnt[i];
             else{
-                Clause& c = ca[reason(var(out_learnt[i]))];
-                for (int k = 1; k < c.size(); k++)
-                    if (!seen[var(c[k])] && level(var(c[k])) > 0){
+                Lit        bin[2];
+                int        size;
+                const Lit* c = reasonLits(x, bin, size);
+                for (int k = 1; k < size; k++)
+                    if (!seen(var(c[k])) && level(var(c[k])) > 0){
                         out_learnt[j++] = out_learnt[i];
                         break; }
             }
@@ -380,7 +602,32 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
         out_btlevel       = level(var(p));
     }
 
-    for (int j = 0; j < analyze_toclear.size(); j++) seen[var(analyze_toclear[j])] = 0;    // ('seen[]' is now cleared)
+    for (int j = 0; j < analyze_toclear.size(); j++) setSeen(var(analyze_toclear[j]), 0);    // ('seen' is now cleared)
+}
+
+
+// Remove the literals 'l' of a minimized conflict clause ('out_learnt[0..j-1]') for which a binary
+// clause '(out_learnt[0] | ~l)' exists; resolving with it strengthens the clause. Only the binary
+// clauses of the asserting literal are visited. The clause is compacted and 'j' updated.
+void Solver::binaryMinimize(vec<Lit>& out_learnt, int& j)
+{
+    // Mark the variables of the clause made redundant ('seen' is 1 for all literals of the clause):
+    const vec<Watcher>& wbin = watches_bin.lookup(~out_learnt[0]);
+    int                 n    = 0;
+    for (int k = 0; k < wbin.size(); k++){
+        Lit imp = wbin[k].blocker;
+        if (seen(var(imp)) == 1 && value(imp) == l_True){
+            setSeen(var(imp), 2);
+            n++; }
+    }
+    if (n == 0) return;
+
+    int k, l;
+    for (k = l = 1; k < j; k++)
+        if (seen(var(out_learnt[k])) != 2)
+            out_learnt[l++] = out_learnt[k];
+    bin_min_literals += j - l;
+    j = l;
 }
 
 
@@ -388,28 +635,30 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 bool Solver::litRedundant(Lit p)
 {
     enum { seen_undef = 0, seen_source = 1, seen_removable = 2, seen_failed = 3 };
-    assert(seen[var(p)] == seen_undef || seen[var(p)] == seen_source);
-    assert(reason(var(p)) != CRef_Undef);
+    assert(seen(var(p)) == seen_undef || seen(var(p)) == seen_source);
+    assert(hasReason(var(p)));
 
-    Clause*               c     = &ca[reason(var(p))];
+    Lit                   bin[2];
+    int                   size;
+    const Lit*            c     = reasonLits(var(p), bin, size);
     vec<ShrinkStackElem>& stack = analyze_stack;
     stack.clear();
 
     for (uint32_t i = 1; ; i++){
-        if (i < (uint32_t)c->size()){
+        if (i < (uint32_t)size){
             // Checking 'p'-parents 'l':
-            Lit l = (*c)[i];
+            Lit l = c[i];
             
             // Variable at level 0 or previously removable:
-            if (level(var(l)) == 0 || seen[var(l)] == seen_source || seen[var(l)] == seen_removable){
+            if (level(var(l)) == 0 || seen(var(l)) == seen_source || seen(var(l)) == seen_removable){
                 continue; }
             
             // Check variable can not be removed for some local reason:
-            if (reason(var(l)) == CRef_Undef || seen[var(l)] == seen_failed){
+            if (!hasReason(var(l)) || seen(var(l)) == seen_failed){
                 stack.push(ShrinkStackElem(0, p));
                 for (int i = 0; i < stack.size(); i++)
-                    if (seen[var(stack[i].l)] == seen_undef){
-                        seen[var(stack[i].l)] = seen_failed;
+                    if (seen(var(stack[i].l)) == seen_undef){
+                        setSeen(var(stack[i].l), seen_failed);
                         analyze_toclear.push(stack[i].l);
                     }
                     
@@ -420,11 +669,11 @@ bool Solver::litRedundant(Lit p)
             stack.push(ShrinkStackElem(i, p));
             i  = 0;
             p  = l;
-            c  = &ca[reason(var(p))];
+            c  = reasonLits(var(p), bin, size);
         }else{
             // Finished with current element 'p' and reason 'c':
-            if (seen[var(p)] == seen_undef){
-                seen[var(p)] = seen_removable;
+            if (seen(var(p)) == seen_undef){
+                setSeen(var(p), seen_removable);
                 analyze_toclear.push(p);
             }
 
@@ -434,7 +683,7 @@ bool Solver::litRedundant(Lit p)
             // Continue with top element on stack:
             i  = stack.last().i;
             p  = stack.last().l;
-            c  = &ca[reason(var(p))];
+            c  = reasonLits(var(p), bin, size);
 
             stack.pop();
         }
@@ -461,33 +710,53 @@ void Solver::analyzeFinal(Lit p, LSet& out_conflict)
     if (decisionLevel() == 0)
         return;
 
-    seen[var(p)] = 1;
+    setSeen(var(p), 1);
 
     for (int i = trail.size()-1; i >= trail_lim[0]; i--){
         Var x = var(trail[i]);
-        if (seen[x]){
-            if (reason(x) == CRef_Undef){
+        if (seen(x)){
+            if (!hasReason(x)){
                 assert(level(x) > 0);
                 out_conflict.insert(~trail[i]);
             }else{
-                Clause& c = ca[reason(x)];
-                for (int j = 1; j < c.size(); j++)
+                Lit        bin[2];
+                int        size;
+                const Lit* c = reasonLits(x, bin, size);
+                for (int j = 1; j < size; j++)
                     if (level(var(c[j])) > 0)
-                        seen[var(c[j])] = 1;
+                        setSeen(var(c[j]), 1);
             }
-            seen[x] = 0;
+            setSeen(x, 0);
         }
     }
 
-    seen[var(p)] = 0;
+    setSeen(var(p), 0);
+}
+
+
+void Solver::uncheckedEnqueue(Lit p, CRef from) { uncheckedEnqueue(p, decisionLevel(), from); }
+void Solver::uncheckedEnqueue(Lit p, Lit from)  { uncheckedEnqueue(p, decisionLevel(), from); }
+
+
+void Solver::uncheckedEnqueue(Lit p, int level, CRef from)
+{
+    assert(value(p) == l_Undef);
+    assert(seen(var(p)) == 0);
+    assert(level <= decisionLevel());
+    assigns.assign(p);
+    vardata[var(p)] = mkVarData(from, level);
+    trail.push_(p);
 }
 
 
-void Solver::uncheckedEnqueue(Lit p, CRef from)
+void Solver::uncheckedEnqueue(Lit p, int level, Lit from)
 {
     assert(value(p) == l_Undef);
-    assigns[var(p)] = lbool(!sign(p));
-    vardata[var(p)] = mkVarData(from, decisionLevel());
+    assert(value(from) == l_False);
+    assert(seen(var(p)) == 0);
+    assert(level <= decisionLevel());
+    assigns.assign(p);
+    vardata[var(p)] = mkVarData(from, level);
     trail.push_(p);
 }
 
@@ -498,7 +767,12 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
 |  
 |  Description:
 |    Propagates all enqueued facts. If a conflict arises, the conflicting clause is returned,
-|    otherwise CRef_Undef.
+|    otherwise CRef_Undef. Binary clauses are propagated first, using only the literal stored
+|    in the watcher. Ternary clauses are propagated next from the two other literals stored in
+|    their watchers; the clause itself is only visited to move an implied literal to the front.
+|
+|    After chronological backtracking, 'p' may be assigned at a level below the current one. The
+|    literals it implies then get the highest level among the false literals of their reason.
 |  
 |    Post-conditions:
 |      * the propagation queue is empty, even if there was a conflict.
@@ -510,11 +784,63 @@ CRef Solver::propagate()
 
     while (qhead < trail.size()){
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
+        int            p_level = level(var(p));
+        vec<Watcher>&  wbin = watches_bin.lookup(p);
+        num_props++;
+
+        for (int k = 0; k < wbin.size(); k++){
+            Lit imp = wbin[k].blocker;
+            if (value(imp) == l_Undef)
+                uncheckedEnqueue(imp, p_level, ~p);
+            else if (value(imp) == l_False){
+                confl = wbin[k].cref;
+                break; }
+        }
+
+        vec<TernaryWatcher>& wtern = watches_tern.lookup(p);
+        for (const TernaryWatcher *w = (TernaryWatcher*)wtern, *wend = w + wtern.size(); w != wend; w++){
+            lbool v1 = value(w->lit1), v2 = value(w->lit2);
+            if (v1 == l_True || v2 == l_True || (v1 == l_Undef && v2 == l_Undef))
+                continue;
+
+            if (v1 == l_False && v2 == l_False){
+                confl = w->cref;
+                break; }
+
+            // Clause is unit under assignment, make sure the implied literal is data[0]:
+            Lit     imp   = v1 == l_Undef ? w->lit1 : w->lit2;
+            Lit     other = v1 == l_Undef ? w->lit2 : w->lit1;
+            Clause& c     = ca[w->cref];
+            if (c[0] != imp){
+                int j = c[1] == imp ? 1 : 2;
+                c[j] = c[0]; c[0] = imp; }
+            int l = p_level;
+            if (l < decisionLevel() && level(var(other)) > l)
+                l = level(var(other));
+            uncheckedEnqueue(imp, l, w->cref);
+        }
+
+        if (confl != CRef_Undef){
+            qhead = trail.size();
+            break; }
+
         vec<Watcher>&  ws  = watches.lookup(p);
         Watcher        *i, *j, *end;
-        num_props++;
+
+#if MINISAT_PREFETCH_DISTANCE > 0
+        // Start fetching the clauses of the first watchers that will have to be inspected:
+        for (i = (Watcher*)ws, end = i + ws.size(); i != end && i < (Watcher*)ws + MINISAT_PREFETCH_DISTANCE; i++)
+            if (value(i->blocker) != l_True)
+                ca.prefetch(i->cref);
+#endif
 
         for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+#if MINISAT_PREFETCH_DISTANCE > 0
+            // Keep fetching clauses a fixed distance ahead of the current watcher:
+            if (end - i > MINISAT_PREFETCH_DISTANCE && value(i[MINISAT_PREFETCH_DISTANCE].blocker) != l_True)
+                ca.prefetch(i[MINISAT_PREFETCH_DISTANCE].cref);
+#endif
+
             // Try to avoid inspecting the clause:
             Lit blocker = i->blocker;
             if (value(blocker) == l_True){
@@ -550,8 +876,22 @@ CRef Solver::propagate()
                 // Copy the remaining watches:
                 while (i < end)
                     *j++ = *i++;
-            }else
+            }else if (p_level == decisionLevel())
                 uncheckedEnqueue(first, cr);
+            else{
+                // Make the false literal of the highest level the other watch, so that it is
+                // unassigned no later than the implied literal:
+                int max_k = 1, max_level = p_level;
+                for (int k = 2; k < c.size(); k++)
+                    if (level(var(c[k])) > max_level){
+                        max_k     = k;
+                        max_level = level(var(c[k])); }
+                if (max_k != 1){
+                    c[1] = c[max_k]; c[max_k] = false_lit;
+                    j--;
+                    watches[~c[1]].push(w); }
+                uncheckedEnqueue(first, max_level, cr);
+            }
 
         NextClause:;
         }
@@ -569,30 +909,49 @@ CRef Solver::propagate()
 |  reduceDB : ()  ->  [void]
 |  
 |  Description:
-|    Remove half of the learnt clauses, minus the clauses locked by the current assignment. Locked
-|    clauses are clauses that are reason to some assignment. Binary clauses are never removed.
+|    Reduce the learnt clauses, which are divided into three tiers by their LBD:
+|      * core  (LBD <= 'core_lbd'):  never removed. Binary clauses always belong here (they are
+|                                    never locked either, since binary reasons are stored inline).
+|      * tier2 (LBD <= 'tier2_lbd'): kept if used in conflict analysis since the last reduction,
+|                                    otherwise treated as local.
+|      * local (the rest):           the less active half is removed, together with clauses with
+|                                    activity smaller than 'extra_lim'.
+|    Clauses locked by the current assignment (reasons for some assignment) are never removed. The
+|    local tier is only partially ordered, enough to find its less active half.
 |________________________________________________________________________________________________@*/
 struct reduceDB_lt { 
     ClauseAllocator& ca;
     reduceDB_lt(ClauseAllocator& ca_) : ca(ca_) {}
-    bool operator () (CRef x, CRef y) { 
-        return ca[x].size() > 2 && (ca[y].size() == 2 || ca[x].activity() < ca[y].activity()); } 
+    bool operator () (CRef x, CRef y) { return ca[x].activity() < ca[y].activity(); } 
 };
 void Solver::reduceDB()
 {
     int     i, j;
     double  extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
 
-    sort(learnts, reduceDB_lt(ca));
-    // Don't delete binary or locked clauses. From the rest, delete clauses from the first half
-    // and clauses with activity smaller than 'extra_lim':
-    for (i = j = 0; i < learnts.size(); i++){
+    // Keep the core tier and the recently used part of tier 2, collect the rest:
+    reduce_local.clear();
+    learnts_core = 0;
+    for (i = 0; i < learnts.size(); i++){
         Clause& c = ca[learnts[i]];
-        if (c.size() > 2 && !locked(c) && (i < learnts.size() / 2 || c.activity() < extra_lim))
-            removeClause(learnts[i]);
-        else
-            learnts[j++] = learnts[i];
+        if (c.size() == 2 || c.lbd() <= core_lbd)
+            learnts_core++;
+        else if (c.lbd() <= tier2_lbd && c.used())
+            c.used(false);
+        else if (!locked(c))
+            reduce_local.push(learnts[i]);
     }
+
+    // Remove the less active half of the local tier and clauses with activity below 'extra_lim':
+    int limit = reduce_local.size() / 2;
+    nthElement(reduce_local, limit, reduceDB_lt(ca));
+    for (i = 0; i < reduce_local.size(); i++)
+        if (i < limit || ca[reduce_local[i]].activity() < extra_lim)
+            removeClause(reduce_local[i]);
+
+    for (i = j = 0; i < learnts.size(); i++)
+        if (!isRemoved(learnts[i]))
+            learnts[j++] = learnts[i];
     learnts.shrink(i - j);
     checkGarbage();
 }
@@ -606,13 +965,21 @@ void Solver::removeSatisfied(vec<CRef>& cs)
         if (satisfied(c))
             removeClause(cs[i]);
         else{
-            // Trim clause:
-            assert(value(c[0]) == l_Undef && value(c[1]) == l_Undef);
-            for (int k = 2; k < c.size(); k++)
+            // Trim clause (NOTE: ternary clauses may have their false literal in any position):
+            assert(c.size() == 3 || (value(c[0]) == l_Undef && value(c[1]) == l_Undef));
+            int k, n_false = 0;
+            for (k = 0; k < c.size(); k++)
+                n_false += value(c[k]) == l_False;
+
+            // A clause that becomes binary or ternary must be moved over to other watcher lists:
+            bool reattach = n_false > 0 && c.size() - n_false <= 3;
+            if (reattach) detachClause(cs[i], true);
+            for (k = 0; k < c.size(); k++)
                 if (value(c[k]) == l_False){
                     c[k--] = c[c.size()-1];
                     c.pop();
                 }
+            if (reattach) attachClause(cs[i]);
             cs[j++] = cs[i];
         }
     }
@@ -620,13 +987,256 @@ void Solver::removeSatisfied(vec<CRef>& cs)
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  vivifyLearnts : ()  ->  [bool]
+|  
+|  Description:
+|    Try to shorten the learnt clauses of the core and tier 2 that have not been vivified before,
+|    best LBD first. For a clause (l1 | l2 | ... | ln), the literals ~l1, ~l2, ... are assigned in
+|    turn, each on a new decision level, and propagated with the clause itself detached:
+|      * a literal that is already false is implied false by the ones before it and is dropped,
+|      * if a literal is already true, or assigning its negation leads to a conflict, the literals
+|        kept so far (including this one) form a clause implied by the others; the rest is dropped.
+|    The clauses are shortened in place. The number of propagations spent is bounded by
+|    'vivify_eff' times the number made by the search since the last call. Must be called at
+|    decision level 0. Returns FALSE if the clause set was found to be unsatisfiable.
+|________________________________________________________________________________________________@*/
+struct vivify_lt { 
+    ClauseAllocator& ca;
+    vivify_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) { 
+        Clause& cx = ca[x];
+        Clause& cy = ca[y];
+        return cx.lbd() < cy.lbd() || (cx.lbd() == cy.lbd() && cx.activity() > cy.activity()); }
+};
+bool Solver::vivifyLearnts()
+{
+    assert(decisionLevel() == 0);
+    int64_t  budget       = (int64_t)((propagations - vivify_props) * vivify_eff);
+    uint64_t start        = propagations;
+    int      saved_phase  = phase_saving;
+    bool     removed      = false;
+    phase_saving = 0;   // (the trial assignments should not overwrite the saved phases)
+
+    vivify_cands.clear();
+    for (int i = 0; i < learnts.size(); i++){
+        const Clause& c = ca[learnts[i]];
+        if (c.size() > 2 && c.lbd() <= tier2_lbd && !c.vivified())
+            vivify_cands.push(learnts[i]);
+    }
+    sort(vivify_cands, vivify_lt(ca));
+
+    for (int i = 0; i < vivify_cands.size() && (int64_t)(propagations - start) < budget; i++){
+        CRef    cr = vivify_cands[i];
+        Clause& c  = ca[cr];
+        c.vivified(true);
+        if (satisfied(c)) continue;
+
+        detachClause(cr, true);
+        int k, j;
+        for (k = j = 0; k < c.size(); k++){
+            Lit p = c[k];
+            if (value(p) == l_False) continue;
+            c[j++] = p;
+            if (value(p) == l_True) break;
+            newDecisionLevel();
+            uncheckedEnqueue(~p);
+            if (propagate() != CRef_Undef) break;
+        }
+        cancelUntil(0);
+
+        if (j == c.size()){
+            attachClause(cr);
+            continue; }
+
+        vivified_clauses++;
+        vivified_literals += c.size() - j;
+        c.shrink(c.size() - j);
+        if (c.size() == 1){
+            uncheckedEnqueue(c[0]);
+            c.mark(1);
+            ca.free(cr);
+            removed = true;
+            if (propagate() != CRef_Undef){
+                ok = false;
+                break; }
+        }else{
+            if (c.lbd() > c.size()) c.lbd(c.size());
+            attachClause(cr);
+        }
+    }
+    phase_saving = saved_phase;
+    vivify_props = propagations;
+
+    if (removed){
+        int i, j;
+        for (i = j = 0; i < learnts.size(); i++)
+            if (!isRemoved(learnts[i]))
+                learnts[j++] = learnts[i];
+        learnts.shrink(i - j);
+    }
+    checkGarbage();
+    return ok;
+}
+
+
+// Check if the long reason of 'q' only depends on literals of the current (probing) level that were
+// implied through binary clauses, or on the probed literal itself. (Resolvents for literals further
+// down the implication graph follow from these, and there can be very many of them.)
+bool Solver::hyperBinary(Lit q)
+{
+    const Clause& c = ca[reason(var(q))];
+    for (int k = 0; k < c.size(); k++){
+        Var x = var(c[k]);
+        if (x != var(q) && level(x) > 0 && reason(x) != CRef_Undef)
+            return false;
+    }
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  probe : (budget : int64_t)  ->  [bool]
+|  
+|  Description:
+|    Failed literal probing on the roots of the binary implication graph. A root is a literal
+|    'p' that implies other literals through binary clauses, but is not implied by any. Each root
+|    'p' is assigned on a new decision level and propagated:
+|      * If there is a conflict, '~p' is a unit (a failed literal).
+|      * Otherwise, a literal 'l' implied through a longer clause, whose other literals were
+|        falsified through binary clauses only, gets the hyper-binary resolvent (~p | l) as a
+|        learnt binary clause. Then '~p' is probed as well. Literals implied by both 'p' and
+|        '~p' are units, and so is 'p' if '~p' fails.
+|    At most one resolvent per ten problem clauses is added in one call.
+|    Stops after 'budget' propagations. The next call continues with the following variables.
+|    Must be called at decision level 0. Returns FALSE if the clause set was found to be
+|    unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::probe(int64_t budget)
+{
+    assert(decisionLevel() == 0);
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+    if (nVars() == 0)
+        return true;
+
+    uint64_t      start       = propagations;
+    int           saved_phase = phase_saving;
+    int           hbr_left    = nClauses() / 10 + 1;   // (learnt binaries are never removed, so don't add too many)
+    vec<uint32_t> stamp(2*nVars(), 0);
+    phase_saving = 0;   // (the trial assignments should not overwrite the saved phases)
+
+    // Collect the roots, starting from where the previous call stopped:
+    watches_bin.cleanAll();
+    probe_roots.clear();
+    if (probe_next >= nVars()) probe_next = 0;
+    for (Var i = 0; i < nVars(); i++){
+        Var v = (probe_next + i) % nVars();
+        if (value(v) != l_Undef || !decision[v]) continue;
+        for (int s = 0; s < 2; s++){
+            Lit p = mkLit(v, s);
+            if (watches_bin[p].size() > 0 && watches_bin[~p].size() == 0)
+                probe_roots.push(p);
+        }
+    }
+
+    int i;
+    for (i = 0; i < probe_roots.size() && (int64_t)(propagations - start) < budget; i++){
+        Lit p = probe_roots[i];
+        if (value(p) != l_Undef) continue;
+        probed_literals++;
+
+        // Probe 'p', and remember what it implies:
+        newDecisionLevel();
+        uncheckedEnqueue(p);
+        bool failed = propagate() != CRef_Undef;
+        probe_hbr.clear();
+        if (!failed)
+            for (int k = trail_lim[0] + 1; k < trail.size(); k++){
+                Lit q = trail[k];
+                stamp[toInt(q)] = i + 1;
+                if (level(var(q)) == 1 && reason(var(q)) != CRef_Undef && hyperBinary(q))
+                    probe_hbr.push(q);
+            }
+        cancelUntil(0);
+
+        probe_units.clear();
+        if (failed)
+            probe_units.push(~p);
+        else{
+            // Probe '~p', and collect the literals implied by both:
+            newDecisionLevel();
+            uncheckedEnqueue(~p);
+            if (propagate() != CRef_Undef)
+                probe_units.push(p);
+            else
+                for (int k = trail_lim[0] + 1; k < trail.size(); k++)
+                    if (level(var(trail[k])) == 1 && stamp[toInt(trail[k])] == (uint32_t)i + 1)
+                        probe_units.push(trail[k]);
+            cancelUntil(0);
+
+            // Add the hyper-binary resolvents:
+            if (probe_units.size() == 0 || probe_units[0] != p)
+                for (int k = 0; k < probe_hbr.size() && hbr_left > 0; k++){
+                    Lit q = probe_hbr[k];
+                    if (value(q) != l_Undef || value(p) != l_Undef) continue;
+                    add_tmp.clear();
+                    add_tmp.push(q);
+                    add_tmp.push(~p);
+                    CRef cr = ca.alloc(add_tmp, true);
+                    ca[cr].lbd(2);
+                    learnts.push(cr);
+                    attachClause(cr);
+                    hyper_binaries++;
+                    hbr_left--;
+                }
+        }
+
+        // Add the units found:
+        if (probe_units.size() > 0){
+            failed_literals += failed || probe_units[0] == p;
+            for (int k = 0; k < probe_units.size() && ok; k++)
+                if (value(probe_units[k]) == l_False)
+                    ok = false;
+                else if (value(probe_units[k]) == l_Undef)
+                    uncheckedEnqueue(probe_units[k]);
+            if (!ok || propagate() != CRef_Undef){
+                ok = false;
+                break; }
+        }
+    }
+    if (i < probe_roots.size())
+        probe_next = var(probe_roots[i]);
+    phase_saving = saved_phase;
+    checkGarbage();
+
+    return ok;
+}
+
+
 void Solver::rebuildOrderHeap()
 {
     vec<Var> vs;
     for (Var v = 0; v < nVars(); v++)
         if (decision[v] && value(v) == l_Undef)
             vs.push(v);
-    order_heap.build(vs);
+    order->build(vs);
+}
+
+
+void VmtfOrder::conflict()
+{
+    // Keep the relative order of the bumped variables by moving the least recent first:
+    sort(bumped, StampLt(queue));
+    for (int i = 0; i < bumped.size(); i++){
+        Var v = bumped[i];
+        queue.moveToFront(v);
+        if (assigns[v] == l_Undef && decision[v])
+            queue.insert(v);
+    }
+    bumped.clear();
 }
 
 
@@ -657,20 +1267,20 @@ bool Solver::simplify()
 
         // Remove all released variables from the trail:
         for (int i = 0; i < released_vars.size(); i++){
-            assert(seen[released_vars[i]] == 0);
-            seen[released_vars[i]] = 1;
+            assert(seen(released_vars[i]) == 0);
+            setSeen(released_vars[i], 1);
         }
 
         int i, j;
         for (i = j = 0; i < trail.size(); i++)
-            if (seen[var(trail[i])] == 0)
+            if (seen(var(trail[i])) == 0)
                 trail[j++] = trail[i];
         trail.shrink(i - j);
         //printf("trail.size()= %d, qhead = %d\n", trail.size(), qhead);
         qhead = trail.size();
 
         for (int i = 0; i < released_vars.size(); i++)
-            seen[released_vars[i]] = 0;
+            setSeen(released_vars[i], 0);
 
         // Released variables are now ready to be reused:
         append(released_vars, free_vars);
@@ -688,22 +1298,21 @@ bool Solver::simplify()
 
 /*_________________________________________________________________________________________________
 |
-|  search : (nof_conflicts : int) (params : const SearchParams&)  ->  [lbool]
+|  search : (restarts : RestartPolicy&)  ->  [lbool]
 |  
 |  Description:
-|    Search for a model the specified number of conflicts. 
-|    NOTE! Use negative value for 'nof_conflicts' indicate infinity.
+|    Search for a model until 'restarts' decides to restart. 'restarts' is told about every
+|    learnt clause and asked before each decision.
 |  
 |  Output:
 |    'l_True' if a partial assigment that is consistent with respect to the clauseset is found. If
 |    all variables are decision variables, this means that the clause set is satisfiable. 'l_False'
-|    if the clause set is unsatisfiable. 'l_Undef' if the bound on number of conflicts is reached.
+|    if the clause set is unsatisfiable. 'l_Undef' if the search restarts (or the budget ran out).
 |________________________________________________________________________________________________@*/
-lbool Solver::search(int nof_conflicts)
+lbool Solver::search(RestartPolicy& restarts)
 {
     assert(ok);
     int         backtrack_level;
-    int         conflictC = 0;
     vec<Lit>    learnt_clause;
     starts++;
 
@@ -711,24 +1320,70 @@ lbool Solver::search(int nof_conflicts)
         CRef confl = propagate();
         if (confl != CRef_Undef){
             // CONFLICT
-            conflicts++; conflictC++;
-            if (decisionLevel() == 0) return l_False;
+            conflicts++;
+            int trail_size = trail.size();
+
+            // After chronological backtracking the conflict may be below the current level:
+            bool single;
+            int  confl_level = conflictLevel(confl, single);
+            if (confl_level == 0) return l_False;
+            if (single){
+                // Only one literal from the conflict level, the clause is unit on the level below. The
+                // highest of the other literals becomes the second watch, so that the clause is
+                // visited again when backtracking unassigns it:
+                Clause& c     = ca[confl];
+                int     max_k = 1;
+                for (int k = 2; k < c.size(); k++)
+                    if (level(var(c[k])) > level(var(c[max_k])))
+                        max_k = k;
+                int l = level(var(c[max_k]));
+                restarts.conflict(computeLBD(c), trail_size);
+                if (max_k != 1){
+                    Lit tmp = c[1]; c[1] = c[max_k]; c[max_k] = tmp;
+
+                    // Only clauses larger than ternary depend on the position of their watched literals:
+                    if (c.size() > 3){
+                        remove(watches[~c[max_k]], Watcher(confl, c[0]));
+                        watches[~c[1]].push(Watcher(confl, c[0])); }
+                }
+                cancelUntil(confl_level - 1);
+                if (c.size() == 2)
+                    uncheckedEnqueue(c[0], l, c[1]);
+                else
+                    uncheckedEnqueue(c[0], l, confl);
+                continue;
+            }
+            cancelUntil(confl_level);
 
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level);
-            cancelUntil(backtrack_level);
+            int lbd = computeLBD(learnt_clause);
+            restarts.conflict(lbd, trail_size);
+
+            // Backtrack a single level instead of a long backjump, keeping the assignments of the
+            // levels in between:
+            if (chrono >= 0 && conflicts > (uint64_t)confl_to_chrono && decisionLevel() - backtrack_level > chrono){
+                chrono_backtracks++;
+                cancelUntil(decisionLevel() - 1);
+            }else
+                cancelUntil(backtrack_level);
 
             if (learnt_clause.size() == 1){
-                uncheckedEnqueue(learnt_clause[0]);
+                uncheckedEnqueue(learnt_clause[0], 0, CRef_Undef);
             }else{
                 CRef cr = ca.alloc(learnt_clause, true);
+                ca[cr].lbd(lbd);
                 learnts.push(cr);
                 attachClause(cr);
                 claBumpActivity(ca[cr]);
-                uncheckedEnqueue(learnt_clause[0], cr);
+                if (learnt_clause.size() == 2)
+                    uncheckedEnqueue(learnt_clause[0], backtrack_level, learnt_clause[1]);
+                else
+                    uncheckedEnqueue(learnt_clause[0], backtrack_level, cr);
             }
+            exportLearnt(learnt_clause, lbd);
 
-            varDecayActivity();
+            order->conflict();
             claDecayActivity();
 
             if (--learntsize_adjust_cnt == 0){
@@ -745,17 +1400,35 @@ lbool Solver::search(int nof_conflicts)
 
         }else{
             // NO CONFLICT
-            if ((nof_conflicts >= 0 && conflictC >= nof_conflicts) || !withinBudget()){
-                // Reached bound on number of conflicts:
+            bool restart = restarts.restart();
+            if (restart || !withinBudget()){
+                // Restart (or reached the budget):
                 progress_estimate = progressEstimate();
                 cancelUntil(0);
+                if (restart) restarts.restarted();
                 return l_Undef; }
 
             // Simplify the set of problem clauses:
             if (decisionLevel() == 0 && !simplify())
                 return l_False;
 
-            if (learnts.size()-nAssigns() >= max_learnts)
+            // Probe for failed literals:
+            if (decisionLevel() == 0 && probe_eff > 0 && conflicts >= next_probe){
+                next_probe = conflicts + probe_interval;
+                bool res   = probe((int64_t)((propagations - probe_props) * probe_eff));
+                probe_props = propagations;
+                if (!res)
+                    return l_False;
+            }
+
+            // Strengthen the best learnt clauses:
+            if (decisionLevel() == 0 && vivify_eff > 0 && conflicts >= next_vivify){
+                next_vivify = conflicts + vivify_interval;
+                if (!vivifyLearnts())
+                    return l_False;
+            }
+
+            if (learnts.size()-learnts_core-nAssigns() >= max_learnts)
                 // Reduce the set of learnt clauses:
                 reduceDB();
 
@@ -835,6 +1508,52 @@ static double luby(double y, int x){
     return pow(y, seq);
 }
 
+
+void LubyRestarts::reset()
+{
+    curr_restarts = 0;
+    conflictC     = 0;
+    limit         = first;
+}
+
+
+void LubyRestarts::restarted()
+{
+    curr_restarts++;
+    conflictC     = 0;
+    limit         = (int)((use_luby ? luby(inc, curr_restarts) : pow(inc, curr_restarts)) * first);
+}
+
+
+void EmaRestarts::reset()
+{
+    lbd_fast  = lbd_slow = trail_avg = 0;
+    conflictC = 0;
+    since     = 0;
+}
+
+
+void EmaRestarts::conflict(int lbd, int trail_size)
+{
+    conflictC++;
+    since++;
+
+    // Block restarts for a while if the trail is unusually large:
+    if (block > 0 && conflictC > 10000 && since >= 50 && trail_size > block * trail_avg){
+        since = 0;
+        blocked++; }
+
+    update(trail_avg, trail_size, 1.0 / 5000);
+    update(lbd_fast,  lbd,        1.0 / 50);
+    update(lbd_slow,  lbd,        1e-5);
+}
+
+
+bool EmaRestarts::restart()
+{
+    return since >= 50 && lbd_fast > margin * lbd_slow;
+}
+
 // NOTE: assumptions passed in member-variable 'assumptions'.
 lbool Solver::solve_()
 {
@@ -844,12 +1563,15 @@ lbool Solver::solve_()
 
     solves++;
 
-    max_learnts = nClauses() * learntsize_factor;
-    if (max_learnts < min_learnts_lim)
-        max_learnts = min_learnts_lim;
+    // (a restored search continues with the limits it had)
+    if (!restored){
+        max_learnts = nClauses() * learntsize_factor;
+        if (max_learnts < min_learnts_lim)
+            max_learnts = min_learnts_lim;
 
-    learntsize_adjust_confl   = learntsize_adjust_start_confl;
-    learntsize_adjust_cnt     = (int)learntsize_adjust_confl;
+        learntsize_adjust_confl   = learntsize_adjust_start_confl;
+        learntsize_adjust_cnt     = (int)learntsize_adjust_confl;
+    }
     lbool   status            = l_Undef;
 
     if (verbosity >= 1){
@@ -860,12 +1582,40 @@ lbool Solver::solve_()
     }
 
     // Search:
-    int curr_restarts = 0;
+    luby_restarts.use_luby = luby_restart;
+    luby_restarts.first    = restart_first;
+    luby_restarts.inc      = restart_inc;
+    ema_restarts .margin   = restart_margin;
+    ema_restarts .block    = restart_block;
+    RestartPolicy& restarts = restart_policy != NULL ? *restart_policy : ema_restart ? (RestartPolicy&)ema_restarts : luby_restarts;
+    restarts.reset();
+    vsids.var_decay = var_decay;
+    DecisionHeuristic* heuristic = vmtf ? (DecisionHeuristic*)&vmtf_order : &vsids;
+    if (heuristic != order){
+        order = heuristic;
+        rebuildOrderHeap(); }
+    if (!restored){
+        next_vivify  = conflicts + vivify_interval;
+        vivify_props = propagations;
+        next_probe   = conflicts + probe_interval;
+        probe_props  = propagations; }
+    restored        = false;
+    next_checkpoint = realTime() + checkpoint_interval;
     while (status == l_Undef){
-        double rest_base = luby_restart ? luby(restart_inc, curr_restarts) : pow(restart_inc, curr_restarts);
-        status = search(rest_base * restart_first);
+        status = search(restarts);
         if (!withinBudget()) break;
-        curr_restarts++;
+        if (status == l_Undef && !inprocess()) status = l_False;
+
+        // Periodic checkpoint (between restarts, so at decision level 0):
+        if (status == l_Undef && checkpoint_file != NULL && realTime() >= next_checkpoint){
+            double start = realTime();
+            bool   saved = checkpoint(checkpoint_file);
+            if (verbosity >= 1 && saved)
+                printf("| Checkpoint written in %8.2f s                                            |\n", realTime() - start);
+            else if (!saved)
+                fprintf(stderr, "WARNING! Could not write checkpoint to %s\n", checkpoint_file);
+            next_checkpoint = realTime() + checkpoint_interval;
+        }
     }
 
     if (verbosity >= 1)
@@ -910,6 +1660,244 @@ bool Solver::implies(const vec<Lit>& assumps, vec<Lit>& out)
     return ret;
 }
 
+//=================================================================================================
+// Checkpoints:
+
+
+/*_________________________________________________________________________________________________
+|
+|  checkpoint : (file : const char*)  ->  [bool]
+|
+|  Description:
+|    Write the state of the solver to 'file': the clause region as it is (so clause references stay
+|    valid), the problem and learnt clauses, the top-level assignments, the variable activities,
+|    polarities and modes, the limits and schedules of the search, and the statistics. Watchers and
+|    the decision order are rebuilt by 'restore()'. The restart policy starts over, as in any call
+|    to 'solve()'. The file is written under a temporary name and then renamed, so an interrupted
+|    checkpoint leaves the previous one intact. Must be called at decision level 0.
+|________________________________________________________________________________________________@*/
+bool Solver::checkpoint(const char* file)
+{
+    assert(decisionLevel() == 0);
+    vec<char> tmp;
+    for (const char* p = file; *p; p++) tmp.push(*p);
+    const char* suffix = ".tmp";
+    for (const char* p = suffix; *p; p++) tmp.push(*p);
+    tmp.push(0);
+
+    FILE* f = fopen(tmp, "wb");
+    if (f == NULL) return false;
+
+    CheckpointWriter out(f);
+    out.put("MSATCKPT", 8);
+    out.put((uint32_t)checkpoint_version);
+    out.put((uint32_t)sizeof(CRef));
+    saveState(out);
+
+    bool saved = out.ok();
+    if (fclose(f) != 0 || !saved || rename(tmp, file) != 0){
+        ::remove(tmp);
+        return false; }
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  restore : (file : const char*)  ->  [bool]
+|
+|  Description:
+|    Read a state written by 'checkpoint()' into this solver, which must not have any variables
+|    yet. The next call to 'solve()' continues the checkpointed search. Returns FALSE if the file
+|    could not be read, or was written by another version or a build with another size of clause
+|    references; the solver is then unusable.
+|________________________________________________________________________________________________@*/
+bool Solver::restore(const char* file)
+{
+    assert(nVars() == 0 && clauses.size() == 0 && learnts.size() == 0);
+    FILE* f = fopen(file, "rb");
+    if (f == NULL) return false;
+
+    CheckpointReader in(f);
+    char     magic[8];
+    uint32_t version, cref_size;
+    bool     loaded = in.get(magic, 8) && memcmp(magic, "MSATCKPT", 8) == 0
+                   && in.get(version) && version == checkpoint_version
+                   && in.get(cref_size) && cref_size == sizeof(CRef)
+                   && loadState(in)
+                   && fgetc(f) == EOF;   // (the state of another class of solver may be longer)
+    fclose(f);
+    return loaded;
+}
+
+
+void Solver::saveState(CheckpointWriter& out)
+{
+    out.put(ok);
+    out.put(nVars());
+    out.put(next_var);
+
+    // Variables:
+    vec<double>   act;
+    vec<char>     pol, dec;
+    vec<lbool>    upol;
+    vec<uint64_t> stamps;
+    for (Var v = 0; v < nVars(); v++){
+        act   .push(vsids.activity[v]);
+        pol   .push(polarity[v]);
+        upol  .push(user_pol[v]);
+        dec   .push(decision[v]);
+        stamps.push(vmtf_order.queue.stamp(v)); }
+    out.put(act);
+    out.put(pol);
+    out.put(upol);
+    out.put(dec);
+    out.put(stamps);
+    out.put(released_vars);
+    out.put(free_vars);
+
+    // Top-level assignments:
+    vec<Lit> units;
+    for (TrailIterator t = trailBegin(); t != trailEnd(); ++t)
+        units.push(*t);
+    out.put(units);
+
+    // Clauses:
+    out.put(ca.size());
+    out.put(ca.wasted());
+    out.put(ca.extra_clause_field);
+    out.put(ca.region(), ca.size());
+    out.put(clauses);
+    out.put(learnts);
+    out.put(learnts_core);
+
+    // Search:
+    out.put(vsids.var_inc);
+    out.put(cla_inc);
+    out.put(random_seed);
+    out.put(simpDB_assigns);
+    out.put(simpDB_props);
+    out.put(remove_satisfied);
+    out.put(next_vivify);
+    out.put(vivify_props);
+    out.put(next_probe);
+    out.put(probe_props);
+    out.put(probe_next);
+    out.put(progress_estimate);
+    out.put(max_learnts);
+    out.put(learntsize_adjust_confl);
+    out.put(learntsize_adjust_cnt);
+
+    // Statistics:
+    uint64_t stats[] = { solves, starts, decisions, rnd_decisions, propagations, conflicts, max_literals, tot_literals,
+                         chrono_backtracks, bin_min_literals, vivified_clauses, vivified_literals,
+                         probed_literals, failed_literals, hyper_binaries };
+    out.put(stats, sizeof(stats) / sizeof(stats[0]));
+}
+
+
+struct StampLt {
+    const vec<uint64_t>& stamps;
+    bool operator () (Var x, Var y) const { return stamps[x] < stamps[y]; }
+    StampLt(const vec<uint64_t>& s) : stamps(s) {}
+};
+
+
+bool Solver::loadState(CheckpointReader& in)
+{
+    int n_vars;
+    Var next;
+    if (!in.get(ok) || !in.get(n_vars) || !in.get(next) || n_vars < 0 || next != n_vars)
+        return in.fail();
+
+    // Variables:
+    vec<double>   act;
+    vec<char>     pol, dec;
+    vec<lbool>    upol;
+    vec<uint64_t> stamps;
+    vec<Var>      released, free;
+    if (!in.get(act, n_vars) || !in.get(pol, n_vars) || !in.get(upol, n_vars) || !in.get(dec, n_vars) || !in.get(stamps, n_vars) ||
+        !in.get(released, n_vars) || !in.get(free, n_vars) ||
+        act.size() != n_vars || pol.size() != n_vars || upol.size() != n_vars || dec.size() != n_vars || stamps.size() != n_vars)
+        return in.fail();
+    for (Var v = 0; v < n_vars; v++){
+        newVar(upol[v], dec[v]);
+        vsids.activity[v] = act[v];
+        polarity[v] = pol[v]; }
+
+    // (only now, or 'newVar()' would have reused the free variables)
+    for (int i = 0; i < released.size(); i++)
+        if (released[i] < 0 || released[i] >= n_vars) return in.fail();
+    for (int i = 0; i < free.size(); i++)
+        if (free[i] < 0 || free[i] >= n_vars) return in.fail();
+    released.moveTo(released_vars);
+    free    .moveTo(free_vars);
+
+    // Restore the order of the VMTF queue:
+    vec<Var> vs;
+    for (Var v = 0; v < n_vars; v++) vs.push(v);
+    sort(vs, StampLt(stamps));
+    vmtf_order.queue.clear();
+    for (int i = 0; i < vs.size(); i++)
+        vmtf_order.queue.newVar(vs[i]);
+
+    // Top-level assignments:
+    vec<Lit> units;
+    if (!in.get(units, n_vars)) return false;
+    for (int i = 0; i < units.size(); i++){
+        if (var(units[i]) < 0 || var(units[i]) >= n_vars || value(units[i]) != l_Undef)
+            return in.fail();
+        uncheckedEnqueue(units[i]); }
+    // (not all of them need be propagated: after chronological backtracking, the literals kept
+    // at level 0 are queued again, see 'cancelUntil()')
+    qhead = 0;
+
+    // Clauses:
+    ClauseAllocator::Size size, wasted;
+    if (!in.get(size) || !in.get(wasted) || !in.get(ca.extra_clause_field) || wasted > size ||
+        !in.get(ca.resize(size, wasted), size) ||
+        !in.get(clauses) || !in.get(learnts) || !in.get(learnts_core))
+        return in.fail();
+    // The file is checked to describe valid, disjoint clauses over the variables, not for being
+    // the state of the same search:
+    vec<CRef> crs;
+    clauses.copyTo(crs);
+    for (int i = 0; i < learnts.size(); i++) crs.push(learnts[i]);
+    sort(crs);
+    for (int i = 0; i < crs.size(); i++){
+        CRef cr = crs[i];
+        if (cr >= size || ca.words(cr) > size - cr || (i+1 < crs.size() && ca.words(cr) > crs[i+1] - cr)) return in.fail();
+        const Clause& c = ca[cr];
+        if (c.size() < 2 || c.mark() != 0 || c.reloced() || (c.learnt() && !c.has_extra())) return in.fail();
+        for (int k = 0; k < c.size(); k++)
+            if (var(c[k]) < 0 || var(c[k]) >= n_vars) return in.fail();
+    }
+    for (int i = 0; i < clauses.size(); i++)
+        if (ca[clauses[i]].learnt()) return in.fail();
+    for (int i = 0; i < learnts.size(); i++)
+        if (!ca[learnts[i]].learnt()) return in.fail();
+    for (int i = 0; i < clauses.size(); i++) attachClause(clauses[i]);
+    for (int i = 0; i < learnts.size(); i++) attachClause(learnts[i]);
+
+    // Search:
+    if (!in.get(vsids.var_inc) || !in.get(cla_inc) || !in.get(random_seed) || !in.get(simpDB_assigns) || !in.get(simpDB_props) ||
+        !in.get(remove_satisfied) || !in.get(next_vivify) || !in.get(vivify_props) || !in.get(next_probe) ||
+        !in.get(probe_props) || !in.get(probe_next) || !in.get(progress_estimate) || !in.get(max_learnts) ||
+        !in.get(learntsize_adjust_confl) || !in.get(learntsize_adjust_cnt))
+        return in.fail();
+
+    // Statistics:
+    uint64_t* stats[] = { &solves, &starts, &decisions, &rnd_decisions, &propagations, &conflicts, &max_literals, &tot_literals,
+                          &chrono_backtracks, &bin_min_literals, &vivified_clauses, &vivified_literals,
+                          &probed_literals, &failed_literals, &hyper_binaries };
+    for (unsigned i = 0; i < sizeof(stats) / sizeof(stats[0]); i++)
+        if (!in.get(*stats[i])) return false;
+
+    rebuildOrderHeap();
+    restored = true;
+    return true;
+}
+
 //=================================================================================================
 // Writing CNF to DIMACS:
 // 
@@ -988,15 +1976,94 @@ void Solver::toDimacs(FILE* f, const vec<Lit>& assumps)
 }
 
 
+// Write the problem clauses in the binary CNF format of 'BinaryCnf.h'. Unlike 'toDimacs()', variables
+// keep their numbers. Top-level units come first, then the clauses not yet satisfied, without their
+// false literals.
+void Solver::toBinary(FILE* f)
+{
+    // Count what will be written:
+    int      n_units   = decisionLevel() == 0 ? trail.size() : trail_lim[0];
+    uint64_t n_clauses = ok ? n_units : 1;
+    uint64_t n_lits    = ok ? n_units : 0;
+    if (ok)
+        for (int i = 0; i < clauses.size(); i++){
+            const Clause& c = ca[clauses[i]];
+            if (satisfied(c)) continue;
+            n_clauses++;
+            for (int j = 0; j < c.size(); j++)
+                if (value(c[j]) != l_False)
+                    n_lits++;
+        }
+
+    BinaryCnfHeader h;
+    memcpy(h.magic, "MSATBCNF", 8);
+    h.version = binary_cnf_version;
+    h.vars    = nVars();
+    h.clauses = n_clauses;
+    h.lits    = n_lits;
+    fwrite(&h, sizeof(h), 1, f);
+
+    // Write the sizes, then the literals (in buffered blocks):
+    vec<uint32_t> buf;
+    for (int pass = 0; pass < 2; pass++){
+        if (!ok){
+            if (pass == 0) buf.push(0);    // (the empty clause)
+        }else{
+            for (int i = 0; i < n_units; i++)
+                buf.push(pass == 0 ? 1 : toInt(trail[i]));
+            for (int i = 0; i < clauses.size(); i++){
+                const Clause& c = ca[clauses[i]];
+                if (satisfied(c)) continue;
+                uint32_t size = 0;
+                for (int j = 0; j < c.size(); j++)
+                    if (value(c[j]) != l_False){
+                        if (pass == 1) buf.push(toInt(c[j]));
+                        size++; }
+                if (pass == 0) buf.push(size);
+                if (buf.size() >= 65536){
+                    fwrite((uint32_t*)buf, sizeof(uint32_t), buf.size(), f);
+                    buf.clear(); }
+            }
+        }
+        fwrite((uint32_t*)buf, sizeof(uint32_t), buf.size(), f);
+        buf.clear();
+    }
+
+    if (verbosity > 0)
+        printf("Wrote binary CNF with %d variables and %" PRIu64 " clauses.\n", nVars(), n_clauses);
+}
+
+
+void Solver::toBinary(const char* file)
+{
+    FILE* f = fopen(file, "wb");
+    if (f == NULL)
+        fprintf(stderr, "could not open file %s\n", file), exit(1);
+    toBinary(f);
+    if (fclose(f) != 0)
+        fprintf(stderr, "could not write file %s\n", file), exit(1);
+}
+
+
 void Solver::printStats() const
 {
     double cpu_time = cpuTime();
     double mem_used = memUsedPeak();
     printf("restarts              : %" PRIu64 "\n", starts);
+    if (ema_restart && restart_policy == NULL)
+        printf("blocked restarts      : %" PRIu64 "\n", ema_restarts.blocked);
     printf("conflicts             : %-12" PRIu64 "   (%.0f /sec)\n", conflicts   , conflicts   /cpu_time);
     printf("decisions             : %-12" PRIu64 "   (%4.2f %% random) (%.0f /sec)\n", decisions, (float)rnd_decisions*100 / (float)decisions, decisions   /cpu_time);
     printf("propagations          : %-12" PRIu64 "   (%.0f /sec)\n", propagations, propagations/cpu_time);
     printf("conflict literals     : %-12" PRIu64 "   (%4.2f %% deleted)\n", tot_literals, (max_literals - tot_literals)*100 / (double)max_literals);
+    if (ccmin_mode == 3)
+        printf("  binary minimized    : %-12" PRIu64 "   (%4.2f %% deleted)\n", bin_min_literals, bin_min_literals*100 / (double)max_literals);
+    if (chrono >= 0)
+        printf("chrono backtracks     : %-12" PRIu64 "   (%4.2f %% of conflicts)\n", chrono_backtracks, chrono_backtracks*100 / (double)conflicts);
+    if (probe_eff > 0)
+        printf("probed literals       : %-12" PRIu64 "   (%" PRIu64 " failed, %" PRIu64 " hyper-binary resolvents)\n", probed_literals, failed_literals, hyper_binaries);
+    if (vivify_eff > 0)
+        printf("vivified clauses      : %-12" PRIu64 "   (%" PRIu64 " literals removed)\n", vivified_clauses, vivified_literals);
     if (mem_used != 0) printf("Memory used           : %.2f MB\n", mem_used);
     printf("CPU time              : %g s\n", cpu_time);
 }
@@ -1010,12 +2077,20 @@ void Solver::relocAll(ClauseAllocator& to)
     // All watchers:
     //
     watches.cleanAll();
+    watches_bin.cleanAll();
+    watches_tern.cleanAll();
     for (int v = 0; v < nVars(); v++)
         for (int s = 0; s < 2; s++){
             Lit p = mkLit(v, s);
             vec<Watcher>& ws = watches[p];
             for (int j = 0; j < ws.size(); j++)
                 ca.reloc(ws[j].cref, to);
+            vec<Watcher>& wbin = watches_bin[p];
+            for (int j = 0; j < wbin.size(); j++)
+                ca.reloc(wbin[j].cref, to);
+            vec<TernaryWatcher>& wtern = watches_tern[p];
+            for (int j = 0; j < wtern.size(); j++)
+                ca.reloc(wtern[j].cref, to);
         }
 
     // All reasons:
@@ -1027,7 +2102,7 @@ void Solver::relocAll(ClauseAllocator& to)
         // 'dangling' reasons here. It is safe and does not hurt.
         if (reason(v) != CRef_Undef && (ca[reason(v)].reloced() || locked(ca[reason(v)]))){
             assert(!isRemoved(reason(v)));
-            ca.reloc(vardata[v].reason, to);
+            ca.reloc(vardata[v].reason.cref, to);
         }
     }
 
@@ -1060,7 +2135,7 @@ void Solver::garbageCollect()
 
     relocAll(to);
     if (verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n", 
-               ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
+        printf("|  Garbage collection:   %12" PRIu64 " bytes => %12" PRIu64 " bytes             |\n", 
+               (uint64_t)ca.size()*ClauseAllocator::Unit_Size, (uint64_t)to.size()*ClauseAllocator::Unit_Size);
     to.moveTo(ca);
 }
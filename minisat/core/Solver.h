@@ -21,16 +21,183 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Solver_h
 #define Minisat_Solver_h
 
+#include <atomic>
+
 #include "minisat/mtl/Vec.h"
 #include "minisat/mtl/Heap.h"
 #include "minisat/mtl/Alg.h"
 #include "minisat/mtl/IntMap.h"
 #include "minisat/utils/Options.h"
 #include "minisat/core/SolverTypes.h"
+#include "minisat/core/Checkpoint.h"
+
 
+// Arity of the variable heaps of 'Solver' and 'SimpSolver' (see 'Heap'). It changes the layout of
+// the solver classes, so it must be the same for the library and all code including its headers.
+#ifndef MINISAT_HEAP_ARITY
+#define MINISAT_HEAP_ARITY 4
+#endif
 
 namespace Minisat {
 
+//=================================================================================================
+// Restart policies -- decide when 'Solver::search()' restarts:
+
+
+class RestartPolicy {
+public:
+    virtual ~RestartPolicy() {}
+    virtual void reset    () = 0;                        // Forget all history (called at the start of each 'solve()').
+    virtual void conflict (int lbd, int trail_size) = 0; // A clause of LBD 'lbd' was learnt in a conflict with 'trail_size' assigned literals.
+    virtual bool restart  () = 0;                        // Should the search restart now? (asked before each decision)
+    virtual void restarted() = 0;                        // The search was restarted.
+};
+
+
+// Restarts after a number of conflicts following the Luby sequence, or a geometric sequence:
+class LubyRestarts : public RestartPolicy {
+    int    curr_restarts;
+    int    limit;          // Conflicts allowed before the next restart.
+    int    conflictC;      // Conflicts since the last restart.
+
+public:
+    bool   use_luby;       // Use the Luby sequence (otherwise a geometric sequence).
+    int    first;          // The base restart interval.
+    double inc;            // The base of the sequence.
+
+    LubyRestarts() : use_luby(true), first(100), inc(2) { reset(); }
+
+    void reset    ();
+    void conflict (int, int) { conflictC++; }
+    bool restart  ()         { return conflictC >= limit; }
+    void restarted();
+};
+
+
+// Glucose-style dynamic restarts: restart when the LBD of recently learnt clauses ('fast' moving
+// average) is high compared to the long term ('slow' moving average). A restart is blocked when
+// the trail is much larger than its recent average, as the search may then be close to a model.
+class EmaRestarts : public RestartPolicy {
+    double   lbd_fast, lbd_slow, trail_avg;
+    uint64_t conflictC;    // Conflicts since the start.
+    int      since;        // Conflicts since the last restart (or blocked restart).
+
+    // Exponential moving average, but a plain average during the first '1/alpha' updates so that
+    // it is not biased by its initial value:
+    void update(double& avg, double x, double alpha) {
+        double a = 1.0 / conflictC;
+        if (a < alpha) a = alpha;
+        avg += a * (x - avg); }
+
+public:
+    double   margin;       // Restart if the fast LBD average exceeds the slow one by this factor.
+    double   block;        // Block restarts if the trail exceeds its average by this factor (0 = never).
+    uint64_t blocked;      // Number of blocked restarts (statistics, not reset).
+
+    EmaRestarts() : margin(1.25), block(1.4), blocked(0) { reset(); }
+
+    void reset    ();
+    void conflict (int lbd, int trail_size);
+    bool restart  ();
+    void restarted() { since = 0; }
+};
+
+
+//=================================================================================================
+// Decision heuristics -- decide which variable 'Solver::pickBranchLit()' assigns next:
+//
+// The solver inserts every variable that becomes unassigned (and is a decision variable), and
+// bumps the variables taking part in each conflict. Picked variables may turn out to be assigned;
+// the solver skips them.
+
+
+class DecisionHeuristic {
+public:
+    virtual ~DecisionHeuristic() {}
+    virtual void insert   (Var v) = 0;                // Variable 'v' may be picked (again).
+    virtual bool empty    () const = 0;               // Is there no variable left to pick?
+    virtual Var  removeMin() = 0;                     // Pick the best variable, which may not be picked again until inserted.
+    virtual Var  random   (double r) = 0;             // A random variable for 'r' in [0, 1), for random decisions.
+    virtual void bump     (Var v) = 0;                // Variable 'v' takes part in the conflict being analyzed.
+    virtual void conflict () = 0;                     // The conflict is analyzed and the solver has backtracked.
+    virtual void build    (const vec<Var>& vs) = 0;   // Exactly the variables 'vs' may be picked.
+};
+
+
+// VSIDS: pick the variable of highest activity. Bumping adds 'var_inc' to the activity of a
+// variable, and all activities decay after each conflict (by increasing 'var_inc' instead):
+class VsidsOrder : public DecisionHeuristic {
+public:
+    VMap<double> activity;     // A heuristic measurement of the activity of a variable.
+    double       var_inc;      // Amount to bump next variable with.
+    double       var_decay;    // The factor with which all activities decay after each conflict.
+
+    VsidsOrder() : var_inc(1), var_decay(0.95), heap(VarOrderLt(activity)) {}
+
+    void newVar   (Var v, double act) { activity.insert(v, act); }
+    void insert   (Var v)             { if (!heap.inHeap(v)) heap.insert(v); }
+    bool empty    () const            { return heap.empty(); }
+    Var  removeMin()                  { return heap.removeMin(); }
+    Var  random   (double r)          { return heap[(int)(r * heap.size())]; }
+    void bump     (Var v)             { bump(v, var_inc); }
+    void bump     (Var v, double inc);
+    void conflict ()                  { var_inc *= (1 / var_decay); }
+    void build    (const vec<Var>& vs){ heap.build(vs); }
+
+protected:
+    struct VarOrderLt {
+        const IntMap<Var, double>&  activity;
+        bool operator () (Var x, Var y) const { return activity[x] > activity[y]; }
+        VarOrderLt(const IntMap<Var, double>&  act) : activity(act) { }
+    };
+
+    Heap<Var,VarOrderLt,MkIndexDefault<Var>,MINISAT_HEAP_ARITY>
+                 heap;         // The variables that may be picked, ordered by activity.
+};
+
+inline void VsidsOrder::bump(Var v, double inc) {
+    if ( (activity[v] += inc) > 1e100 ) {
+        // Rescale:
+        for (double* a = activity.begin(); a != activity.end(); a++)
+            *a *= 1e-100;
+        var_inc *= 1e-100; }
+
+    // Update heap with respect to new activity:
+    if (heap.inHeap(v))
+        heap.decrease(v); }
+
+
+// VMTF: pick the variable bumped most recently. The variables bumped in a conflict are moved to
+// the front of the queue together, once the conflict is over (keeping their relative order):
+class VmtfOrder : public DecisionHeuristic {
+public:
+    VmtfQueue    queue;        // The variables in the order they were last bumped.
+
+    VmtfOrder(const LitValues& a, const VMap<char>& d) : assigns(a), decision(d), n_vars(0) {}
+
+    void newVar   (Var v)             { queue.newVar(v); if (v >= n_vars) n_vars = v + 1; }
+    void insert   (Var v)             { queue.insert(v); }
+    bool empty    () const            { return queue.empty(); }
+    Var  removeMin()                  { return queue.removeMin(); }
+    Var  random   (double r)          { return (Var)(r * n_vars); }
+    void bump     (Var v)             { bumped.push(v); }
+    void conflict ();
+    void build    (const vec<Var>& vs){ queue.build(vs); }
+
+protected:
+    const LitValues&  assigns;      // (of the solver, to tell which of the moved variables may be picked)
+    const VMap<char>& decision;
+    vec<Var>          bumped;       // Variables bumped in the current conflict.
+    int               n_vars;
+
+    struct StampLt {
+        const VmtfQueue& queue;
+        bool operator () (Var x, Var y) const { return queue.stamp(x) < queue.stamp(y); }
+        StampLt(const VmtfQueue& q) : queue(q) { }
+    };
+};
+
+
 //=================================================================================================
 // Solver -- the main class:
 
@@ -55,6 +222,9 @@ public:
     bool    addClause (Lit p, Lit q, Lit r, Lit s);             // Add a quaternary clause to the solver. 
     bool    addClause_(      vec<Lit>& ps);                     // Add a clause to the solver without making superflous internal copy. Will
                                                                 // change the passed vector 'ps'.
+    bool    addClauses(const uint32_t* sizes, const uint32_t* lits, uint64_t n_clauses);
+                                                                // Add clauses in bulk: clause 'i' has 'sizes[i]' literals, taken in turn
+                                                                // from 'lits' (as 'toInt(Lit)'). See 'BinaryCnf.h'.
 
     // Solving:
     //
@@ -79,6 +249,14 @@ public:
     void    toDimacs     (const char *file, const vec<Lit>& assumps);
     void    toDimacs     (FILE* f, Clause& c, vec<Var>& map, Var& max);
 
+    void    toBinary     (FILE* f);                                 // Write CNF to file in binary format (see 'BinaryCnf.h').
+    void    toBinary     (const char* file);
+
+    // Checkpoints (see 'Checkpoint.h'):
+    //
+    bool    checkpoint   (const char* file);    // Write the state of the solver to 'file' (at decision level 0). Returns FALSE on failure.
+    bool    restore      (const char* file);    // Continue from a state written by 'checkpoint()'. The solver must be empty. Returns FALSE on failure.
+
     // Convenience versions of 'toDimacs()':
     void    toDimacs     (const char* file);
     void    toDimacs     (const char* file, Lit p);
@@ -131,12 +309,27 @@ public:
     double    random_var_freq;
     double    random_seed;
     bool      luby_restart;
-    int       ccmin_mode;         // Controls conflict clause minimization (0=none, 1=basic, 2=deep).
+    bool      ema_restart;        // Use dynamic (Glucose-style) restarts instead of a fixed sequence.
+    double    restart_margin;     // (ema) Restart if the recent average LBD exceeds the long term one by this factor.       (default 1.25)
+    double    restart_block;      // (ema) Block restarts if the trail exceeds its recent average by this factor (0 = never). (default 1.4)
+    RestartPolicy* restart_policy;// If set, used instead of the above restart policies.
+    int       ccmin_mode;         // Controls conflict clause minimization (0=none, 1=basic, 2=deep, 3=deep+binary).
     int       phase_saving;       // Controls the level of phase saving (0=none, 1=limited, 2=full).
     bool      rnd_pol;            // Use random polarities for branching heuristics.
     bool      rnd_init_act;       // Initialize variable activities with a small random value.
+    bool      vmtf;               // Use the variable-move-to-front queue instead of VSIDS for decisions (set before solving).
     double    garbage_frac;       // The fraction of wasted memory allowed before a garbage collection is triggered.
     int       min_learnts_lim;    // Minimum number to set the learnts limit to.
+    int       core_lbd;           // Learnt clauses with an LBD of at most this value are never removed.                       (default 2)
+    int       tier2_lbd;          // Learnt clauses with an LBD of at most this value are kept while they are used.            (default 6)
+    int       chrono;             // Backtrack chronologically if a backjump would skip more levels than this (-1 = never).    (default -1)
+    int       confl_to_chrono;    // Number of conflicts before chronological backtracking is allowed.                         (default 4000)
+    double    vivify_eff;         // Vivify learnt clauses with at most this many propagations per search propagation (0 = off). (default 0)
+    int       vivify_interval;    // Number of conflicts between two rounds of learnt clause vivification.                     (default 2000)
+    double    probe_eff;          // Probe with at most this many propagations per search propagation (0 = off).              (default 0.05)
+    int       probe_interval;     // Number of conflicts between two rounds of failed literal probing.                         (default 5000)
+    const char* checkpoint_file;  // If set, 'solve()' writes a checkpoint to this file between restarts (see 'checkpoint()').
+    double    checkpoint_interval;// Wall-clock seconds between two checkpoints written by 'solve()'.                           (default 600)
 
     int       restart_first;      // The initial restart limit.                                                                (default 100)
     double    restart_inc;        // The factor with which the restart limit is multiplied in each restart.                    (default 1.5)
@@ -150,13 +343,24 @@ public:
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
     uint64_t dec_vars, num_clauses, num_learnts, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t chrono_backtracks, bin_min_literals, vivified_clauses, vivified_literals;
+    uint64_t probed_literals, failed_literals, hyper_binaries;
 
 protected:
 
     // Helper structures:
     //
-    struct VarData { CRef reason; int level; };
-    static inline VarData mkVarData(CRef cr, int l){ VarData d = {cr, l}; return d; }
+    // The per-variable fields visited together by 'analyze()' and 'litRedundant()', packed into
+    // one record (8 bytes with 32-bit clause references). The reason is either a clause or, if
+    // 'bin' is set, the other literal of a binary clause. The 'seen' marks are only set while
+    // analyzing, and are cleared again whenever a variable is assigned.
+    struct VarData {
+        union { CRef cref; Lit lit; } reason;
+        unsigned level : 29;
+        unsigned bin   : 1;
+        unsigned seen  : 2; };
+    static inline VarData mkVarData(CRef cr, int l){ VarData d; d.reason.cref = cr; d.level = l; d.bin = 0; d.seen = 0; return d; }
+    static inline VarData mkVarData(Lit  bp, int l){ VarData d; d.reason.lit  = bp; d.level = l; d.bin = 1; d.seen = 0; return d; }
 
     struct Watcher {
         CRef cref;
@@ -166,17 +370,23 @@ protected:
         bool operator!=(const Watcher& w) const { return cref != w.cref; }
     };
 
+    // Ternary clauses are watched on all three literals, and each watcher keeps the two other
+    // literals. Watches never have to move, and the order of literals in the clause itself is
+    // only relevant for reasons.
+    struct TernaryWatcher {
+        CRef cref;
+        Lit  lit1, lit2;
+        TernaryWatcher(CRef cr, Lit p, Lit q) : cref(cr), lit1(p), lit2(q) {}
+        bool operator==(const TernaryWatcher& w) const { return cref == w.cref; }
+        bool operator!=(const TernaryWatcher& w) const { return cref != w.cref; }
+    };
+
     struct WatcherDeleted
     {
         const ClauseAllocator& ca;
         WatcherDeleted(const ClauseAllocator& _ca) : ca(_ca) {}
-        bool operator()(const Watcher& w) const { return ca[w.cref].mark() == 1; }
-    };
-
-    struct VarOrderLt {
-        const IntMap<Var, double>&  activity;
-        bool operator () (Var x, Var y) const { return activity[x] > activity[y]; }
-        VarOrderLt(const IntMap<Var, double>&  act) : activity(act) { }
+        template<class W>
+        bool operator()(const W& w) const { return ca[w.cref].mark() == 1; }
     };
 
     struct ShrinkStackElem {
@@ -189,28 +399,43 @@ protected:
     //
     vec<CRef>           clauses;          // List of problem clauses.
     vec<CRef>           learnts;          // List of learnt clauses.
+    int                 learnts_core;     // Number of learnt clauses in the core tier at the last 'reduceDB()'.
     vec<Lit>            trail;            // Assignment stack; stores all assigments made in the order they were made.
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail'.
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
 
-    VMap<double>        activity;         // A heuristic measurement of the activity of a variable.
-    VMap<lbool>         assigns;          // The current assignments.
+    LitValues           assigns;          // The current assignments (of both literals of each variable).
     VMap<char>          polarity;         // The preferred polarity of each variable.
     VMap<lbool>         user_pol;         // The users preferred polarity of each variable.
     VMap<char>          decision;         // Declares if a variable is eligible for selection in the decision heuristic.
-    VMap<VarData>       vardata;          // Stores reason and level for each variable.
+    VMap<VarData>       vardata;          // Stores reason, level and 'seen' mark for each variable.
     OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>
                         watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>
+                        watches_bin;      // 'watches_bin[lit]' is a list of binary clauses watching 'lit'. The blocker is the other literal.
+    OccLists<Lit, vec<TernaryWatcher>, WatcherDeleted, MkIndexLit>
+                        watches_tern;     // 'watches_tern[lit]' is a list of ternary clauses watching 'lit'.
+
+    LubyRestarts        luby_restarts;    // The restart policies (unless 'restart_policy' is set).
+    EmaRestarts         ema_restarts;
 
-    Heap<Var,VarOrderLt>order_heap;       // A priority queue of variables ordered with respect to the variable activity.
+    VsidsOrder          vsids;            // The decision heuristics (see 'vmtf').
+    VmtfOrder           vmtf_order;
+    DecisionHeuristic*  order;            // The decision heuristic in use.
 
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
     double              cla_inc;          // Amount to bump next clause with.
-    double              var_inc;          // Amount to bump next variable with.
     int                 qhead;            // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplify()'.
     int64_t             simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplify()'.
+    uint64_t            next_vivify;      // Number of conflicts at which 'vivifyLearnts()' is run next.
+    uint64_t            vivify_props;     // Number of propagations at the end of the last 'vivifyLearnts()'.
+    uint64_t            next_probe;       // Number of conflicts at which 'probe()' is run next from 'search()'.
+    uint64_t            probe_props;      // Number of propagations at the end of the last 'probe()' from 'search()'.
+    Var                 probe_next;       // The variable at which the next 'probe()' starts looking for roots.
     double              progress_estimate;// Set by 'search()'.
+    double              next_checkpoint;  // Wall-clock time at which 'solve_()' writes the next checkpoint.
+    bool                restored;         // Set by 'restore()': the next 'solve_()' keeps the limits and schedules of the checkpointed search.
     bool                remove_satisfied; // Indicates whether possibly inefficient linear scan for satisfied clauses should be performed in 'simplify'.
     Var                 next_var;         // Next variable to be created.
     ClauseAllocator     ca;
@@ -219,12 +444,19 @@ protected:
     vec<Var>            free_vars;
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which it is
-    // used, exept 'seen' wich is used in several places.
+    // used. (The 'seen' marks, which are used in several places, are kept in 'vardata'.)
     //
-    VMap<char>          seen;
     vec<ShrinkStackElem>analyze_stack;
     vec<Lit>            analyze_toclear;
     vec<Lit>            add_tmp;
+    vec<CRef>           reduce_local;
+    vec<CRef>           vivify_cands;
+    vec<Lit>            probe_roots;
+    vec<Lit>            probe_hbr;
+    vec<Lit>            probe_units;
+    vec<Lit>            cancel_keep;
+    vec<uint32_t>       lbd_seen;
+    uint32_t            lbd_counter;
 
     double              max_learnts;
     double              learntsize_adjust_confl;
@@ -234,31 +466,42 @@ protected:
     //
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
-    bool                asynch_interrupt;
+    std::atomic<bool>   asynch_interrupt;   // (may be set from another thread or a signal handler, see 'interrupt()')
 
     // Main internal methods:
     //
-    void     insertVarOrder   (Var x);                                                 // Insert a variable in the decision order priority queue.
+    void     insertVarOrder   (Var x);                                                 // Insert a variable in the decision order priority queue (or VMTF queue).
     Lit      pickBranchLit    ();                                                      // Return the next decision variable.
     void     newDecisionLevel ();                                                      // Begins a new decision level.
     void     uncheckedEnqueue (Lit p, CRef from = CRef_Undef);                         // Enqueue a literal. Assumes value of literal is undefined.
+    void     uncheckedEnqueue (Lit p, Lit from);                                       // Enqueue a literal implied by the binary clause (p | from).
+    void     uncheckedEnqueue (Lit p, int level, CRef from);                           // Enqueue a literal at a level below the current one (see 'chrono').
+    void     uncheckedEnqueue (Lit p, int level, Lit from);
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
+    int      conflictLevel    (CRef confl, bool& single);                              // Level of a conflict, which may be below the current level.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel);    // (bt = backtrack)
     void     analyzeFinal     (Lit p, LSet& out_conflict);                             // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p);                                                 // (helper method for 'analyze()')
-    lbool    search           (int nof_conflicts);                                     // Search for a given number of conflicts.
+    void     binaryMinimize   (vec<Lit>& out_learnt, int& j);                          // (helper method for 'analyze()')
+    template<class C>
+    int      computeLBD       (const C& c);                                            // Number of distinct decision levels among the literals of 'c'.
+    lbool    search           (RestartPolicy& restarts);                               // Search until a conflict or restart as decided by 'restarts'.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
+    virtual bool inprocess    ();                                                      // Called at level 0 between restarts. Returns FALSE if unsatisfiable.
+    virtual void exportLearnt (const vec<Lit>& c, int lbd);                            // Called with each clause learnt from a conflict.
+    virtual void saveState    (CheckpointWriter& out);                                 // Write the state for 'checkpoint()'.
+    virtual bool loadState    (CheckpointReader& in);                                  // Read the state written by 'saveState()'. Returns FALSE on failure.
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
+    bool     vivifyLearnts    ();                                                      // Strengthen the best learnt clauses by propagation.
+    bool     probe            (int64_t budget);                                        // Failed literal probing with at most 'budget' propagations.
+    bool     hyperBinary      (Lit q);                                                 // Is '(~p | q)' a first-level hyper-binary resolvent for the probe 'p'?
     void     rebuildOrderHeap ();
 
     // Maintaining Variable/Clause activity:
     //
-    void     varDecayActivity ();                      // Decay all variables with the specified factor. Implemented by increasing the 'bump' value instead.
-    void     varBumpActivity  (Var v, double inc);     // Increase a variable with the current 'bump' value.
-    void     varBumpActivity  (Var v);                 // Increase a variable with the current 'bump' value.
     void     claDecayActivity ();                      // Decay all clauses with the specified factor. Implemented by increasing the 'bump' value instead.
     void     claBumpActivity  (Clause& c);             // Increase a clause with the current 'bump' value.
 
@@ -276,9 +519,15 @@ protected:
     int      decisionLevel    ()      const; // Gives the current decisionlevel.
     uint32_t abstractLevel    (Var x) const; // Used to represent an abstraction of sets of decision levels.
     CRef     reason           (Var x) const;
+    Lit      binReason        (Var x) const; // The other literal of the binary clause that implied 'x', or 'lit_Undef'.
+    bool     hasReason        (Var x) const; // FALSE for decisions and for top-level facts without a reason.
+    const Lit* reasonLits     (Var x, Lit* tmp, int& size); // The literals of the reason for 'x' (binary reasons are expanded into 'tmp').
     int      level            (Var x) const;
+    int      seen             (Var x) const; // Temporary mark used during conflict analysis (see 'VarData').
+    void     setSeen          (Var x, int s);
     double   progressEstimate ()      const; // DELETE THIS ?? IT'S NOT VERY USEFUL ...
     bool     withinBudget     ()      const;
+    bool     interrupted      ()      const;
     void     relocAll         (ClauseAllocator& to);
 
     // Static helpers:
@@ -300,26 +549,45 @@ protected:
 //=================================================================================================
 // Implementation of inline methods:
 
-inline CRef Solver::reason(Var x) const { return vardata[x].reason; }
-inline int  Solver::level (Var x) const { return vardata[x].level; }
-
-inline void Solver::insertVarOrder(Var x) {
-    if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x); }
-
-inline void Solver::varDecayActivity() { var_inc *= (1 / var_decay); }
-inline void Solver::varBumpActivity(Var v) { varBumpActivity(v, var_inc); }
-inline void Solver::varBumpActivity(Var v, double inc) {
-    if ( (activity[v] += inc) > 1e100 ) {
-        // Rescale:
-        for (int i = 0; i < nVars(); i++)
-            activity[i] *= 1e-100;
-        var_inc *= 1e-100; }
-
-    // Update order_heap with respect to new activity:
-    if (order_heap.inHeap(v))
-        order_heap.decrease(v); }
+inline CRef Solver::reason   (Var x) const { return vardata[x].bin ? CRef_Undef : vardata[x].reason.cref; }
+inline Lit  Solver::binReason(Var x) const { return vardata[x].bin ? vardata[x].reason.lit : lit_Undef; }
+inline bool Solver::hasReason(Var x) const { return vardata[x].bin || vardata[x].reason.cref != CRef_Undef; }
+inline int  Solver::level    (Var x) const { return vardata[x].level; }
+inline int  Solver::seen     (Var x) const { return vardata[x].seen; }
+inline void Solver::setSeen  (Var x, int s){ vardata[x].seen = s; }
+
+inline const Lit* Solver::reasonLits(Var x, Lit* tmp, int& size) {
+    assert(hasReason(x));
+    if (reason(x) != CRef_Undef){
+        const Clause& c = ca[reason(x)];
+        size = c.size();
+        return c; }
+    tmp[0] = mkLit(x, value(x) == l_False);
+    tmp[1] = binReason(x);
+    size   = 2;
+    return tmp; }
+
+inline void Solver::insertVarOrder(Var x) { if (decision[x]) order->insert(x); }
 
 inline void Solver::claDecayActivity() { cla_inc *= (1 / clause_decay); }
+template<class C>
+inline int Solver::computeLBD(const C& c) {
+    if (++lbd_counter == 0){
+        // Stamp counter wrapped around; start over:
+        for (int i = 0; i < lbd_seen.size(); i++) lbd_seen[i] = 0;
+        lbd_counter = 1; }
+    if (lbd_seen.size() <= decisionLevel())
+        lbd_seen.growTo(decisionLevel()+1, 0);
+
+    int lbd = 0;
+    for (int i = 0; i < c.size(); i++){
+        int l = level(var(c[i]));
+        if (lbd_seen[l] != lbd_counter){
+            lbd_seen[l] = lbd_counter;
+            lbd++; }
+    }
+    return lbd; }
+
 inline void Solver::claBumpActivity (Clause& c) {
         if ( (c.activity() += cla_inc) > 1e20 ) {
             // Rescale:
@@ -342,13 +610,14 @@ inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r, Lit s){ add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); add_tmp.push(s); return addClause_(add_tmp); }
 
 inline bool     Solver::isRemoved       (CRef cr)         const { return ca[cr].mark() == 1; }
+// NOTE: binary clauses are never locked since binary reasons are stored inline in 'vardata'.
 inline bool     Solver::locked          (const Clause& c) const { return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
 
 inline int      Solver::decisionLevel ()      const   { return trail_lim.size(); }
 inline uint32_t Solver::abstractLevel (Var x) const   { return 1 << (level(x) & 31); }
 inline lbool    Solver::value         (Var x) const   { return assigns[x]; }
-inline lbool    Solver::value         (Lit p) const   { return assigns[var(p)] ^ sign(p); }
+inline lbool    Solver::value         (Lit p) const   { return assigns[p]; }
 inline lbool    Solver::modelValue    (Var x) const   { return model[x]; }
 inline lbool    Solver::modelValue    (Lit p) const   { return model[var(p)] ^ sign(p); }
 inline int      Solver::nAssigns      ()      const   { return trail.size(); }
@@ -368,11 +637,13 @@ inline void     Solver::setDecisionVar(Var v, bool b)
 }
 inline void     Solver::setConfBudget(int64_t x){ conflict_budget    = conflicts    + x; }
 inline void     Solver::setPropBudget(int64_t x){ propagation_budget = propagations + x; }
-inline void     Solver::interrupt(){ asynch_interrupt = true; }
-inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
+// NOTE: the flag only asks the search to stop soon; it orders no other memory, so relaxed accesses suffice.
+inline void     Solver::interrupt(){ asynch_interrupt.store(true, std::memory_order_relaxed); }
+inline void     Solver::clearInterrupt(){ asynch_interrupt.store(false, std::memory_order_relaxed); }
+inline bool     Solver::interrupted() const { return asynch_interrupt.load(std::memory_order_relaxed); }
 inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
 inline bool     Solver::withinBudget() const {
-    return !asynch_interrupt &&
+    return !interrupted() &&
            (conflict_budget    < 0 || conflicts < (uint64_t)conflict_budget) &&
            (propagation_budget < 0 || propagations < (uint64_t)propagation_budget); }
 
@@ -386,6 +657,8 @@ inline bool     Solver::solve         (Lit p, Lit q, Lit r) { budgetOff(); assum
 inline bool     Solver::solve         (const vec<Lit>& assumps){ budgetOff(); assumps.copyTo(assumptions); return solve_() == l_True; }
 inline lbool    Solver::solveLimited  (const vec<Lit>& assumps){ assumps.copyTo(assumptions); return solve_(); }
 inline bool     Solver::okay          ()      const   { return ok; }
+inline bool     Solver::inprocess     ()                    { return true; }
+inline void     Solver::exportLearnt  (const vec<Lit>&, int) { }
 
 inline ClauseIterator Solver::clausesBegin() const { return ClauseIterator(ca, &clauses[0]); }
 inline ClauseIterator Solver::clausesEnd  () const { return ClauseIterator(ca, &clauses[clauses.size()]); }
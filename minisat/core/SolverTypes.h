@@ -131,11 +131,121 @@ inline lbool toLbool(int   v) { return lbool((uint8_t)v);  }
 #endif
 
 
+//=================================================================================================
+// LitValues -- the current values of all literals:
+//
+// NOTE: both literals of a variable are stored (next to each other), so that reading the value of
+// a literal needs no sign adjustment; only 2 bits of each entry are used.
+
+class LitValues {
+    vec<uint8_t> vals;
+
+ public:
+    lbool operator[](Lit p) const { return toLbool(vals[toInt(p)]); }
+    lbool operator[](Var x) const { return toLbool(vals[toInt(mkLit(x))]); }
+
+    void  assign  (Lit p) { vals[toInt(p)] = toInt(l_True); vals[toInt(~p)] = toInt(l_False); }
+    void  unassign(Var x) { vals[toInt(mkLit(x))] = vals[toInt(~mkLit(x))] = toInt(l_Undef); }
+
+    void  insert  (Var x) {
+        vals.growTo(toInt(~mkLit(x)) + 1, (uint8_t)toInt(l_Undef));
+        unassign(x); }
+
+    void  clear   (bool free = false) { vals.clear(free); }
+};
+
+
+//=================================================================================================
+// VmtfQueue -- a variable-move-to-front decision queue:
+//
+// The variables form a doubly linked list, ordered by the time they were last moved to the front
+// ('stamp'). Decisions are taken from the front. The 'search' position is cached: no variable in
+// front of it may be picked, until 'insert()' tells otherwise.
+
+class VmtfQueue {
+    struct Link {
+        Var      prev, next;
+        uint64_t stamp; };
+
+    IntMap<Var, Link> links;
+    Var               first;   // The variable moved to the front least recently.
+    Var               last;    // The variable moved to the front most recently (the front).
+    Var               search;  // Next variable to try; var_Undef if none may be picked.
+    uint64_t          stamps;
+
+    void unlink(Var v){
+        Link& l = links[v];
+        if (l.prev != var_Undef) links[l.prev].next = l.next; else first = l.next;
+        if (l.next != var_Undef) links[l.next].prev = l.prev; else last  = l.prev; }
+
+    void append(Var v){
+        Link& l = links[v];
+        l.prev  = last;
+        l.next  = var_Undef;
+        l.stamp = ++stamps;
+        if (last != var_Undef) links[last].next = v; else first = v;
+        last    = v; }
+
+ public:
+    VmtfQueue() : first(var_Undef), last(var_Undef), search(var_Undef), stamps(0) {}
+
+    bool     empty      ()      const { return search == var_Undef; }
+    bool     has        (Var v) const { return links.has(v) && (v == first || links[v].prev != var_Undef); }
+    uint64_t stamp      (Var v) const { return links[v].stamp; }
+
+    // Add a new variable to the front (it may not be picked before it is inserted):
+    void newVar(Var v){
+        if (has(v)) return;
+        Link l; l.prev = l.next = var_Undef; l.stamp = 0;
+        links.insert(v, l, l);
+        append(v); }
+
+    // Variable 'v' may be picked again:
+    void insert(Var v){
+        if (search == var_Undef || links[v].stamp > links[search].stamp)
+            search = v; }
+
+    // Move 'v' to the front (it may not be picked before it is inserted):
+    void moveToFront(Var v){
+        if (v == last) { links[v].stamp = ++stamps; return; }
+        if (v == search) search = links[v].prev;
+        unlink(v);
+        append(v); }
+
+    // Next variable to try, which is then considered picked:
+    Var removeMin(){
+        assert(!empty());
+        Var v  = search;
+        search = links[v].prev;
+        return v; }
+
+    // Restart the search from the front:
+    void build(const vec<Var>& ns){
+        search = var_Undef;
+        for (int i = 0; i < ns.size(); i++)
+            insert(ns[i]); }
+
+    void clear(bool free = false){
+        links.clear(free);
+        first = last = search = var_Undef;
+        stamps = 0; }
+};
+
+
 //=================================================================================================
 // Clause -- a simple class for representing a clause:
 
+// NOTE: clause references are 32-bit offsets into the clause region by default, which limits it
+// to 2^32 words (16 GB). Defining 'MINISAT_CREF64' (for the library and all code including its
+// headers) makes them 64-bit, which lifts the limit but makes watchers and reasons larger.
+
 class Clause;
-typedef RegionAllocator<uint32_t>::Ref CRef;
+#ifdef MINISAT_CREF64
+typedef RegionAllocator<uint32_t, uint64_t> ClauseRegion;
+#else
+typedef RegionAllocator<uint32_t, uint32_t> ClauseRegion;
+#endif
+typedef ClauseRegion::Ref CRef;
 
 class Clause {
     struct {
@@ -144,7 +254,11 @@ class Clause {
         unsigned has_extra : 1;
         unsigned reloced   : 1;
         unsigned size      : 27; }                        header;
-    union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
+    struct Info {           // (the second extra field of a learnt clause, after its activity)
+        unsigned used      : 1;
+        unsigned vivified  : 1;
+        unsigned lbd       : 4; };
+    union { Lit lit; float act; uint32_t abs; uint32_t rel; Info info; } data[0];
 
     friend class ClauseAllocator;
 
@@ -160,9 +274,12 @@ class Clause {
             data[i].lit = ps[i];
 
         if (header.has_extra){
-            if (header.learnt)
+            if (header.learnt){
                 data[header.size].act = 0;
-            else
+                data[header.size+1].info.used     = 0;
+                data[header.size+1].info.vivified = 0;
+                lbd(ps.size());        // (an upper bound until the real value is known)
+            }else
                 calcAbstraction();
     }
     }
@@ -176,9 +293,10 @@ class Clause {
             data[i].lit = from[i];
 
         if (header.has_extra){
-            if (header.learnt)
-                data[header.size].act = from.data[header.size].act;
-            else 
+            if (header.learnt){
+                data[header.size].act    = from.data[header.size].act;
+                data[header.size+1].info = from.data[header.size+1].info;
+            }else 
                 data[header.size].abs = from.data[header.size].abs;
     }
     }
@@ -193,17 +311,37 @@ public:
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size());
+                                               if (header.has_extra) data[header.size-i]   = data[header.size];
+                                               if (header.learnt)    data[header.size-i+1] = data[header.size+1];
+                                               header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     bool         has_extra   ()      const   { return header.has_extra; }
     uint32_t     mark        ()      const   { return header.mark; }
     void         mark        (uint32_t m)    { header.mark = m; }
+
+    // The literal block distance (LBD) of a learnt clause, saturated at 'LBD_Max', and whether it
+    // took part in conflict analysis since this was last reset, and whether it has already been
+    // vivified (see 'Solver::vivifyLearnts()'):
+    enum { LBD_Max = 15 };
+    int          lbd         ()      const   { assert(header.learnt); return data[header.size+1].info.lbd; }
+    void         lbd         (int l)         { assert(header.learnt); data[header.size+1].info.lbd = l < LBD_Max ? l : LBD_Max; }
+    bool         used        ()      const   { assert(header.learnt); return data[header.size+1].info.used; }
+    void         used        (bool u)        { assert(header.learnt); data[header.size+1].info.used = u; }
+    bool         vivified    ()      const   { assert(header.learnt); return data[header.size+1].info.vivified; }
+    void         vivified    (bool v)        { assert(header.learnt); data[header.size+1].info.vivified = v; }
     const Lit&   last        ()      const   { return data[header.size-1].lit; }
 
     bool         reloced     ()      const   { return header.reloced; }
+#ifdef MINISAT_CREF64
+    // NOTE: a wide relocation is split over the first two words (see 'clauseWord32Size()').
+    CRef         relocation  ()      const   { return (CRef)data[0].rel | ((CRef)data[1].rel << 32); }
+    void         relocate    (CRef c)        { header.reloced = 1; data[0].rel = (uint32_t)c; data[1].rel = (uint32_t)(c >> 32); }
+#else
     CRef         relocation  ()      const   { return data[0].rel; }
     void         relocate    (CRef c)        { header.reloced = 1; data[0].rel = c; }
+#endif
 
     // NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
     //       subsumption operations to behave correctly.
@@ -222,20 +360,28 @@ public:
 //=================================================================================================
 // ClauseAllocator -- a simple class for allocating memory for clauses:
 
-const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
+const CRef CRef_Undef = ClauseRegion::Ref_Undef;
 class ClauseAllocator
 {
-    RegionAllocator<uint32_t> ra;
-
-    static uint32_t clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
+    ClauseRegion ra;
+
+    // NOTE: learnt clauses always have the extra field, and a second one for 'Clause::Info'.
+    static uint32_t clauseWord32Size(int size, bool has_extra, bool learnt = false){
+        int words = size + (int)has_extra + (int)learnt;
+#ifdef MINISAT_CREF64
+        // Make room for a wide relocation, even in unit clauses without an extra field:
+        if (words < 2) words = 2;
+#endif
+        return (sizeof(Clause) + (sizeof(Lit) * words)) / sizeof(uint32_t); }
 
  public:
-    enum { Unit_Size = RegionAllocator<uint32_t>::Unit_Size };
+    typedef ClauseRegion::Size Size;
+    enum { Unit_Size = ClauseRegion::Unit_Size };
+    enum { Max_Size  = 1 << 27 };   // Clauses must have fewer literals than this (see 'Clause::header').
 
     bool extra_clause_field;
 
-    ClauseAllocator(uint32_t start_cap) : ra(start_cap), extra_clause_field(false){}
+    ClauseAllocator(Size start_cap) : ra(start_cap), extra_clause_field(false){}
     ClauseAllocator() : extra_clause_field(false){}
 
     void moveTo(ClauseAllocator& to){
@@ -246,8 +392,9 @@ class ClauseAllocator
     {
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
+        if (ps.size() >= Max_Size) throw OutOfMemoryException();
         bool use_extra = learnt | extra_clause_field;
-        CRef cid       = ra.alloc(clauseWord32Size(ps.size(), use_extra));
+        CRef cid       = ra.alloc(clauseWord32Size(ps.size(), use_extra, learnt));
         new (lea(cid)) Clause(ps, use_extra, learnt);
 
         return cid;
@@ -256,12 +403,22 @@ class ClauseAllocator
     CRef alloc(const Clause& from)
     {
         bool use_extra = from.learnt() | extra_clause_field;
-        CRef cid       = ra.alloc(clauseWord32Size(from.size(), use_extra));
+        CRef cid       = ra.alloc(clauseWord32Size(from.size(), use_extra, from.learnt()));
         new (lea(cid)) Clause(from, use_extra);
         return cid; }
 
-    uint32_t size      () const      { return ra.size(); }
-    uint32_t wasted    () const      { return ra.wasted(); }
+    Size     size      () const      { return ra.size(); }
+    Size     wasted    () const      { return ra.wasted(); }
+    uint32_t words     (CRef r) const{ const Clause& c = operator[](r); return clauseWord32Size(c.size(), c.has_extra(), c.learnt()); }
+
+    // Make room for 'n_clauses' more problem clauses with 'n_lits' literals in total:
+    void reserve(uint64_t n_clauses, uint64_t n_lits){
+        uint64_t words = n_clauses * clauseWord32Size(0, extra_clause_field) + n_lits;
+        if (words == (Size)words) ra.reserve((Size)words); }
+
+    // The whole region as words, to save it and to restore it (see 'Solver::checkpoint()'):
+    const uint32_t* region() const                 { return size() > 0 ? ra.lea(0) : NULL; }
+    uint32_t*       resize(Size words, Size wasted){ ra.resize(words, wasted); return words > 0 ? ra.lea(0) : NULL; }
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
     Clause&       operator[](CRef r)         { return (Clause&)ra[r]; }
@@ -269,11 +426,12 @@ class ClauseAllocator
     Clause*       lea       (CRef r)         { return (Clause*)ra.lea(r); }
     const Clause* lea       (CRef r) const   { return (Clause*)ra.lea(r);; }
     CRef          ael       (const Clause* t){ return ra.ael((uint32_t*)t); }
+    void          prefetch  (CRef r)   const { ra.prefetch(r); }
 
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        ra.free(clauseWord32Size(c.size(), c.has_extra()));
+        ra.free(clauseWord32Size(c.size(), c.has_extra(), c.learnt()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
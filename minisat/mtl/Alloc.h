@@ -26,26 +26,45 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 namespace Minisat {
 
+//=================================================================================================
+// Portable software prefetch hint (a no-op where not supported):
+
+#if defined(__GNUC__)
+#  define MINISAT_PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#  include <xmmintrin.h>
+#  define MINISAT_PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+#  define MINISAT_PREFETCH(addr) ((void)(addr))
+#endif
+
 //=================================================================================================
 // Simple Region-based memory allocator:
+//
+// NOTE: references (and sizes) are of the unsigned integer type 'R', which bounds the region to
+// 2^(8*sizeof(R)) - 1 units. The default 'uint32_t' keeps references compact; a 64-bit type lifts
+// the limit at the cost of twice the space for every stored reference.
 
-template<class T>
+template<class T, class R = uint32_t>
 class RegionAllocator
 {
-    T*        memory;
-    uint32_t  sz;
-    uint32_t  cap;
-    uint32_t  wasted_;
-
-    void capacity(uint32_t min_cap);
-
  public:
     // TODO: make this a class for better type-checking?
-    typedef uint32_t Ref;
-    enum { Ref_Undef = UINT32_MAX };
+    typedef R Ref;
+    typedef R Size;
+    static const Ref Ref_Undef = ~(Ref)0;
     enum { Unit_Size = sizeof(T) };
 
-    explicit RegionAllocator(uint32_t start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0){ capacity(start_cap); }
+ private:
+    T*        memory;
+    Size      sz;
+    Size      cap;
+    Size      wasted_;
+
+    void capacity(Size min_cap);
+
+ public:
+    explicit RegionAllocator(Size start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0){ capacity(start_cap); }
     ~RegionAllocator()
     {
         if (memory != NULL)
@@ -53,8 +72,10 @@ class RegionAllocator
     }
 
 
-    uint32_t size      () const      { return sz; }
-    uint32_t wasted    () const      { return wasted_; }
+    Size     size      () const      { return sz; }
+    Size     wasted    () const      { return wasted_; }
+    void     reserve   (Size n)      { if (sz + n >= sz) capacity(sz + n); }  // Make room for 'n' more units (if the size can hold them).
+    void     resize    (Size n, Size w){ capacity(n); sz = n; wasted_ = w; }  // Set the size, and the part of it wasted (the contents are left to the caller).
 
     Ref      alloc     (int size); 
     void     free      (int size)    { wasted_ += size; }
@@ -65,6 +86,7 @@ class RegionAllocator
 
     T*       lea       (Ref r)       { assert(r < sz); return &memory[r]; }
     const T* lea       (Ref r) const { assert(r < sz); return &memory[r]; }
+    void     prefetch  (Ref r) const { MINISAT_PREFETCH(&memory[r]); }
     Ref      ael       (const T* t)  { assert((void*)t >= (void*)&memory[0] && (void*)t < (void*)&memory[sz-1]);
         return  (Ref)(t - &memory[0]); }
 
@@ -82,18 +104,22 @@ class RegionAllocator
 
 };
 
-template<class T>
-void RegionAllocator<T>::capacity(uint32_t min_cap)
+template<class T, class R>
+const typename RegionAllocator<T, R>::Ref RegionAllocator<T, R>::Ref_Undef;
+
+
+template<class T, class R>
+void RegionAllocator<T, R>::capacity(Size min_cap)
 {
     if (cap >= min_cap) return;
 
-    uint32_t prev_cap = cap;
+    Size prev_cap = cap;
     while (cap < min_cap){
         // NOTE: Multiply by a factor (13/8) without causing overflow, then add 2 and make the
         // result even by clearing the least significant bit. The resulting sequence of capacities
         // is carefully chosen to hit a maximum capacity that is close to the '2^32-1' limit when
         // using 'uint32_t' as indices so that as much as possible of this space can be used.
-        uint32_t delta = ((cap >> 1) + (cap >> 3) + 2) & ~1;
+        Size delta = ((cap >> 1) + (cap >> 3) + 2) & ~(Size)1;
         cap += delta;
 
         if (cap <= prev_cap)
@@ -101,20 +127,24 @@ void RegionAllocator<T>::capacity(uint32_t min_cap)
     }
     // printf(" .. (%p) cap = %u\n", this, cap);
 
+    // Wide references may describe regions that the address space can not hold:
+    if (cap > SIZE_MAX / sizeof(T))
+        throw OutOfMemoryException();
+
     assert(cap > 0);
-    memory = (T*)xrealloc(memory, sizeof(T)*cap);
+    memory = (T*)xrealloc(memory, sizeof(T)*(size_t)cap);
 }
 
 
-template<class T>
-typename RegionAllocator<T>::Ref
-RegionAllocator<T>::alloc(int size)
+template<class T, class R>
+typename RegionAllocator<T, R>::Ref
+RegionAllocator<T, R>::alloc(int size)
 { 
     // printf("ALLOC called (this = %p, size = %d)\n", this, size); fflush(stdout);
     assert(size > 0);
     capacity(sz + size);
 
-    uint32_t prev_sz = sz;
+    Size prev_sz = sz;
     sz += size;
     
     // Handle overflow:
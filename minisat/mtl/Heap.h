@@ -28,58 +28,76 @@ namespace Minisat {
 
 //=================================================================================================
 // A heap implementation with support for decrease/increase key.
+//
+// Each node has 'D' children (a binary heap by default). A larger arity makes the heap shallower,
+// and the children of a node are stored next to each other, so 'percolateDown()' touches fewer
+// cache lines at the price of more comparisons per level.
+//
+// NOTE: element 'i' is stored at 'heap[i + D-1]'. With this padding every group of children starts
+// at a multiple of 'D' in 'heap', so a group with 'D*sizeof(K)' up to the alignment of the
+// allocation (16 bytes with most mallocs) never straddles a cache line.
 
 
-template<class K, class Comp, class MkIndex = MkIndexDefault<K> >
+template<class K, class Comp, class MkIndex = MkIndexDefault<K>, int D = 2>
 class Heap {
-    vec<K>                heap;     // Heap of Keys
+    vec<K>                heap;     // Heap of Keys (after 'pad' unused entries)
     IntMap<K,int,MkIndex> indices;  // Each Key's position (index) in the Heap
     Comp                  lt;       // The heap is a minimum-heap with respect to this comparator
 
+    enum { pad = D - 1 };
+
     // Index "traversal" functions
-    static inline int left  (int i) { return i*2+1; }
-    static inline int right (int i) { return (i+1)*2; }
-    static inline int parent(int i) { return (i-1) >> 1; }
+    static inline int child (int i) { return i*D+1; }   // First child.
+    static inline int parent(int i) { return (i-1) / D; }
+
+    K&       at(int i)       { return heap[i + pad]; }
+    const K& at(int i) const { return heap[i + pad]; }
 
 
     void percolateUp(int i)
     {
-        K   x  = heap[i];
+        K   x  = at(i);
         int p  = parent(i);
         
-        while (i != 0 && lt(x, heap[p])){
-            heap[i]          = heap[p];
-            indices[heap[p]] = i;
-            i                = p;
-            p                = parent(p);
+        while (i != 0 && lt(x, at(p))){
+            at(i)          = at(p);
+            indices[at(p)] = i;
+            i              = p;
+            p              = parent(p);
         }
-        heap   [i] = x;
+        at     (i) = x;
         indices[x] = i;
     }
 
 
     void percolateDown(int i)
     {
-        K x = heap[i];
-        while (left(i) < heap.size()){
-            int child = right(i) < heap.size() && lt(heap[right(i)], heap[left(i)]) ? right(i) : left(i);
-            if (!lt(heap[child], x)) break;
-            heap[i]          = heap[child];
-            indices[heap[i]] = i;
-            i                = child;
+        K   x = at(i);
+        int n = size();
+        while (child(i) < n){
+            int first = child(i);
+            int end   = first + D < n ? first + D : n;
+            int c     = first;
+            for (int k = first + 1; k < end; k++)
+                if (lt(at(k), at(c)))
+                    c = k;
+            if (!lt(at(c), x)) break;
+            at(i)          = at(c);
+            indices[at(i)] = i;
+            i              = c;
         }
-        heap   [i] = x;
+        at     (i) = x;
         indices[x] = i;
     }
 
 
   public:
-    Heap(const Comp& c, MkIndex _index = MkIndex()) : indices(_index), lt(c) {}
+    Heap(const Comp& c, MkIndex _index = MkIndex()) : indices(_index), lt(c) { heap.growTo(pad); }
 
-    int  size      ()          const { return heap.size(); }
-    bool empty     ()          const { return heap.size() == 0; }
+    int  size      ()          const { return heap.size() - pad; }
+    bool empty     ()          const { return heap.size() == pad; }
     bool inHeap    (K k)       const { return indices.has(k) && indices[k] >= 0; }
-    int  operator[](int index) const { assert(index < heap.size()); return heap[index]; }
+    int  operator[](int index) const { assert(index < size()); return at(index); }
 
     void decrease  (K k) { assert(inHeap(k)); percolateUp  (indices[k]); }
     void increase  (K k) { assert(inHeap(k)); percolateDown(indices[k]); }
@@ -101,7 +119,7 @@ class Heap {
         indices.reserve(k, -1);
         assert(!inHeap(k));
 
-        indices[k] = heap.size();
+        indices[k] = size();
         heap.push(k);
         percolateUp(indices[k]);
     }
@@ -114,9 +132,9 @@ class Heap {
         int k_pos  = indices[k];
         indices[k] = -1;
 
-        if (k_pos < heap.size()-1){
-            heap[k_pos]          = heap.last();
-            indices[heap[k_pos]] = k_pos;
+        if (k_pos < size()-1){
+            at(k_pos)          = heap.last();
+            indices[at(k_pos)] = k_pos;
             heap.pop();
             percolateDown(k_pos);
         }else
@@ -126,21 +144,21 @@ class Heap {
 
     K removeMin()
     {
-        K x              = heap[0];
-        heap[0]          = heap.last();
-        indices[heap[0]] = 0;
-        indices[x]       = -1;
+        K x            = at(0);
+        at(0)          = heap.last();
+        indices[at(0)] = 0;
+        indices[x]     = -1;
         heap.pop();
-        if (heap.size() > 1) percolateDown(0);
+        if (size() > 1) percolateDown(0);
         return x; 
     }
 
 
     // Rebuild the heap from scratch, using the elements in 'ns':
     void build(const vec<K>& ns) {
-        for (int i = 0; i < heap.size(); i++)
-            indices[heap[i]] = -1;
-        heap.clear();
+        for (int i = 0; i < size(); i++)
+            indices[at(i)] = -1;
+        heap.shrink(size());
 
         for (int i = 0; i < ns.size(); i++){
             // TODO: this should probably call reserve instead of relying on it being reserved already.
@@ -148,16 +166,17 @@ class Heap {
             indices[ns[i]] = i;
             heap.push(ns[i]); }
 
-        for (int i = heap.size() / 2 - 1; i >= 0; i--)
+        for (int i = size() > 1 ? parent(size() - 1) : -1; i >= 0; i--)
             percolateDown(i);
     }
 
     void clear(bool dispose = false) 
     { 
         // TODO: shouldn't the 'indices' map also be dispose-cleared?
-        for (int i = 0; i < heap.size(); i++)
-            indices[heap[i]] = -1;
+        for (int i = 0; i < size(); i++)
+            indices[at(i)] = -1;
         heap.clear(dispose); 
+        heap.growTo(pad);
     }
 };
 
@@ -0,0 +1,234 @@
+/***************************************************************************************[Cuber.cc]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "minisat/mtl/Sort.h"
+#include "minisat/parallel/Cuber.h"
+#include "minisat/utils/Options.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Options:
+
+
+static const char* _cat = "CUBE";
+
+static IntOption     opt_cube_depth        (_cat, "cube-depth",  "Maximum number of decisions in a cube", 10, IntRange(0, 30));
+static IntOption     opt_cube_cands        (_cat, "cube-cands",  "Number of variables evaluated by lookahead in each node", 100, IntRange(1, INT32_MAX));
+
+
+//=================================================================================================
+// Constructor:
+
+
+Cuber::Cuber() :
+    cube_depth  (opt_cube_depth)
+  , cube_cands  (opt_cube_cands)
+  , cube_nodes  (0)
+  , cube_refuted(0)
+  , cube_failed (0)
+  , lookaheads  (0)
+{}
+
+
+//=================================================================================================
+// Lookahead:
+
+
+struct OccurLt {
+    const vec<uint64_t>& score;
+    bool operator () (Var x, Var y) const { return score[x] > score[y] || (score[x] == score[y] && x < y); }
+    OccurLt(const vec<uint64_t>& s) : score(s) {}
+};
+
+
+// Assign 'p' on a new decision level and propagate. 'score' is set to the number of literals
+// assigned. The level is left for the caller to cancel.
+bool Cuber::lookahead(Lit p, uint64_t& score)
+{
+    int start = trail.size();
+    newDecisionLevel();
+    uncheckedEnqueue(p);
+    lookaheads++;
+    bool ok_ = propagate() == CRef_Undef;
+    score = trail.size() - start;
+    return ok_;
+}
+
+
+// Evaluate both polarities of the first 'cube_cands' unassigned candidates, and pick the variable
+// whose polarities together propagate the most (the product of the counts favours balanced
+// variables). A failed polarity forces the other one on the current level.
+bool Cuber::pickSplit(Lit& best)
+{
+    int      level      = decisionLevel();
+    uint64_t best_score = 0;
+    best = lit_Undef;
+
+    cands_tmp.clear();
+    for (int i = 0; i < cands_order.size() && cands_tmp.size() < cube_cands; i++)
+        if (value(cands_order[i]) == l_Undef)
+            cands_tmp.push(mkLit(cands_order[i]));
+
+    for (int i = 0; i < cands_tmp.size(); i++){
+        Lit p = cands_tmp[i];
+        if (value(p) != l_Undef) continue;
+
+        uint64_t pos, neg;
+        bool     pos_ok = lookahead( p, pos); cancelUntil(level);
+        bool     neg_ok = lookahead(~p, neg); cancelUntil(level);
+
+        if (!pos_ok || !neg_ok){
+            if (!pos_ok && !neg_ok)
+                return false;
+            cube_failed++;
+            uncheckedEnqueue(pos_ok ? p : ~p);
+            if (propagate() != CRef_Undef)
+                return false;
+            if (best != lit_Undef && value(best) != l_Undef){
+                best = lit_Undef;
+                best_score = 0; }
+            continue;
+        }
+
+        uint64_t score = 1024 * pos * neg + pos + neg;
+        if (best == lit_Undef || score > best_score){
+            best       = pos <= neg ? p : ~p;   // (try the less constrained branch first)
+            best_score = score; }
+    }
+    return true;
+}
+
+
+void Cuber::split(vec<vec<Lit> >& out)
+{
+    cube_nodes++;
+    Lit best;
+    if (!pickSplit(best)){
+        cube_refuted++;
+        return; }
+
+    if (decisionLevel() >= cube_depth || best == lit_Undef){
+        out.push();
+        for (int i = 0; i < decisionLevel(); i++)
+            out.last().push(trail[trail_lim[i]]);
+        return; }
+
+    int level = decisionLevel();
+    for (int s = 0; s < 2; s++){
+        Lit p = s == 0 ? best : ~best;
+        newDecisionLevel();
+        uncheckedEnqueue(p);
+        if (propagate() == CRef_Undef)
+            split(out);
+        else
+            cube_refuted++;
+        cancelUntil(level);
+    }
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  cube : (out : vec<vec<Lit> >&)  ->  [bool]
+|
+|  Description:
+|    Split the problem into cubes by lookahead. In each node, the candidate variables are assigned
+|    both ways and propagated, and the one with the best product of propagated literals is split
+|    on. Nodes are split until 'cube_depth' decisions are made; the leaves are stored in 'out' as
+|    lists of decisions (to be solved as assumptions). Refuted nodes give no cube, so 'out' covers
+|    all the models of the problem. Units found at the root are kept.
+|    Must be called at decision level 0. Returns FALSE if the problem was found unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Cuber::cube(vec<vec<Lit> >& out)
+{
+    assert(decisionLevel() == 0);
+    out.clear();
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+
+    // Order the candidates by the number of clauses they occur in (both polarities together):
+    vec<uint64_t> occurs(2*nVars(), 0);
+    vec<uint64_t> score(nVars(), 0);
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        for (int k = 0; k < c.size(); k++)
+            occurs[toInt(c[k])]++; }
+    cands_order.clear();
+    for (Var v = 0; v < nVars(); v++)
+        if (decision[v] && value(v) == l_Undef){
+            score[v] = occurs[toInt(mkLit(v))] * occurs[toInt(~mkLit(v))] + occurs[toInt(mkLit(v))] + occurs[toInt(~mkLit(v))];
+            cands_order.push(v); }
+    sort(cands_order, OccurLt(score));
+
+    int saved_phase = phase_saving;
+    phase_saving = 0;   // (the trial assignments should not overwrite the saved phases)
+    split(out);
+    phase_saving = saved_phase;
+    cancelUntil(0);
+
+    if (out.size() == 0)
+        return ok = false;
+    return ok = propagate() == CRef_Undef;
+}
+
+
+//=================================================================================================
+// iCNF output:
+
+
+// Write the remaining clauses and the top-level units, followed by one line of assumptions per cube.
+// Variables keep their numbers (unlike 'toDimacs()'), so that models and cubes refer to the input.
+void Cuber::toICNF(FILE* f, const vec<vec<Lit> >& cubes)
+{
+    fprintf(f, "p inccnf\n");
+
+    for (TrailIterator t = trailBegin(); t != trailEnd(); ++t)
+        fprintf(f, "%s%d 0\n", sign(*t) ? "-" : "", var(*t)+1);
+
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        if (satisfied(c)) continue;
+        for (int k = 0; k < c.size(); k++)
+            if (value(c[k]) != l_False)
+                fprintf(f, "%s%d ", sign(c[k]) ? "-" : "", var(c[k])+1);
+        fprintf(f, "0\n");
+    }
+
+    for (int i = 0; i < cubes.size(); i++){
+        fprintf(f, "a ");
+        for (int k = 0; k < cubes[i].size(); k++)
+            fprintf(f, "%s%d ", sign(cubes[i][k]) ? "-" : "", var(cubes[i][k])+1);
+        fprintf(f, "0\n");
+    }
+
+    if (verbosity > 0)
+        printf("Wrote iCNF with %d clauses and %d cubes.\n", clauses.size(), cubes.size());
+}
+
+
+void Cuber::toICNF(const char* file, const vec<vec<Lit> >& cubes)
+{
+    FILE* f = fopen(file, "wr");
+    if (f == NULL)
+        fprintf(stderr, "could not open file %s\n", file), exit(1);
+    toICNF(f, cubes);
+    fclose(f);
+}
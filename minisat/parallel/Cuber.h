@@ -0,0 +1,62 @@
+/****************************************************************************************[Cuber.h]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_Cuber_h
+#define Minisat_Cuber_h
+
+#include <stdio.h>
+
+#include "minisat/core/Solver.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Cuber -- split the problem into cubes (conjunctions of literals) by lookahead:
+
+class Cuber : public Solver {
+public:
+    Cuber();
+
+    bool    cube      (vec<vec<Lit> >& out);                      // Returns FALSE if the problem was found unsatisfiable (no cubes).
+    void    toICNF    (FILE* f, const vec<vec<Lit> >& cubes);     // Write clauses and cubes (as assumptions) in iCNF-format.
+    void    toICNF    (const char* file, const vec<vec<Lit> >& cubes);
+
+    // Mode of operation:
+    //
+    int       cube_depth;       // Stop splitting at this many decisions.
+    int       cube_cands;       // Number of variables evaluated by lookahead in each node.
+
+    // Statistics: (read-only member variables)
+    //
+    uint64_t  cube_nodes, cube_refuted, cube_failed, lookaheads;
+
+protected:
+    vec<Var>       cands_order;  // All variables, most occurring first (the lookahead candidates).
+    vec<Lit>       cands_tmp;
+
+    bool     lookahead (Lit p, uint64_t& score);   // Propagate 'p' on a new level. Returns FALSE on conflict.
+    bool     pickSplit (Lit& best);                // Returns FALSE if the node was refuted ('best' is 'lit_Undef' if nothing is left).
+    void     split     (vec<vec<Lit> >& out);
+};
+
+//=================================================================================================
+}
+
+#endif
@@ -0,0 +1,197 @@
+/*****************************************************************************************[Main.cc]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <errno.h>
+#include <zlib.h>
+#include <chrono>
+#include <thread>
+
+#include "minisat/utils/System.h"
+#include "minisat/utils/ParseUtils.h"
+#include "minisat/utils/Options.h"
+#include "minisat/core/Dimacs.h"
+#include "minisat/core/BinaryCnf.h"
+#include "minisat/parallel/Cuber.h"
+#include "minisat/parallel/Portfolio.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+
+
+static Portfolio* portfolio;
+static void SIGINT_interrupt(int) { portfolio->interrupt(); }
+
+// Note that '_exit()' rather than 'exit()' has to be used. The reason is that 'exit()' calls
+// destructors and may cause deadlocks if a malloc/free function happens to be running (these
+// functions are guarded by locks for multithreaded use).
+static void SIGINT_exit(int) {
+    printf("\n"); printf("*** INTERRUPTED ***\n");
+    _exit(1); }
+
+
+static double wallTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+//=================================================================================================
+// Main:
+
+
+int main(int argc, char** argv)
+{
+    try {
+        setUsageHelp("USAGE: %s [options] <input-file> <result-output-file>\n\n  where input may be either in plain or gzipped DIMACS, or in binary CNF.\n");
+        setX86FPUPrecision();
+
+        // Extra options:
+        //
+        IntOption    verb   ("MAIN", "verb",   "Verbosity level (0=silent, 1=some, 2=more).", 1, IntRange(0, 2));
+        IntOption    threads("MAIN", "threads","Number of solver threads (0 = one per hardware thread).", 0, IntRange(0, 1024));
+        IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds (summed over all threads).\n", 0, IntRange(0, INT32_MAX));
+        IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", 0, IntRange(0, INT32_MAX));
+        BoolOption   strictp("MAIN", "strict", "Validate DIMACS header during parsing.", false);
+        IntOption    parse_threads("MAIN", "parse-threads", "Number of threads parsing an uncompressed input file, which is mapped into memory (0 = one per hardware thread, -1 = read it through zlib).", 0, IntRange(-1, 1024));
+        BoolOption   cube   ("MAIN", "cube",   "Split the problem into cubes by lookahead, and solve the cubes in parallel.", false);
+        StringOption icnf   ("MAIN", "icnf",   "Write the cubes to this file in iCNF-format instead of solving them (implies -cube).");
+
+        parseOptions(argc, argv, true);
+
+        int n_threads = threads != 0 ? (int)threads : (int)std::thread::hardware_concurrency();
+        if (n_threads < 1) n_threads = 1;
+
+        Cuber     S;
+        Portfolio P(n_threads);
+        double    initial_time = wallTime();
+
+        S.verbosity = 0;
+        P.verbosity = verb;
+
+        portfolio = &P;
+        // Use signal handlers that forcibly quit until the solvers will be able to respond to
+        // interrupts:
+        sigTerm(SIGINT_exit);
+
+        // Try to set resource limits:
+        if (cpu_lim != 0) limitTime(cpu_lim);
+        if (mem_lim != 0) limitMemory(mem_lim);
+
+        if (argc == 1)
+            printf("Reading from standard input... Use '--help' for help.\n");
+
+        // Uncompressed files are mapped into memory (and parsed in parallel chunks on several threads).
+        // Binary CNF files are always read this way:
+        MappedFile mapped;
+        bool       use_mmap = argc > 1 && mapped.open(argv[1]) && !mapped.isGzip()
+                           && (parse_threads >= 0 || isBinaryCNF(mapped.data(), mapped.size()));
+        gzFile     in       = use_mmap ? NULL : (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
+        if (!use_mmap && in == NULL)
+            printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
+
+        if (verb > 0){
+            printf("============================[ Problem Statistics ]=============================\n");
+            printf("|                                                                             |\n"); }
+
+        if (use_mmap && isBinaryCNF(mapped.data(), mapped.size())){
+            parse_BinaryCNF(mapped, S);
+            mapped.close();
+        }else if (use_mmap){
+            parse_DIMACS(mapped, S, (bool)strictp, parse_threads != 0 ? (int)parse_threads : (int)std::thread::hardware_concurrency());
+            mapped.close();
+        }else{
+            parse_DIMACS(in, S, (bool)strictp);
+            gzclose(in); }
+        FILE* res = (argc >= 3) ? fopen(argv[2], "wb") : NULL;
+
+        if (verb > 0){
+            printf("|  Number of variables:  %12d                                         |\n", S.nVars());
+            printf("|  Number of clauses:    %12d                                         |\n", S.nClauses());
+            printf("|  Number of threads:    %12d                                         |\n", n_threads); }
+
+        bool   loaded      = S.simplify();
+        double parsed_time = wallTime();
+        if (verb > 0){
+            printf("|  Parse time:           %12.2f s                                       |\n", parsed_time - initial_time);
+            printf("|                                                                             |\n"); }
+
+        vec<vec<Lit> > cubes;
+        bool           use_cubes = cube || icnf != NULL;
+        if (loaded && use_cubes){
+            loaded = S.cube(cubes);
+            double cubed_time = wallTime();
+            if (verb > 0){
+                printf("|  Number of cubes:      %12d                                         |\n", cubes.size());
+                printf("|  Refuted nodes:        %12" PRIu64 "                                         |\n", S.cube_refuted);
+                printf("|  Failed literals:      %12" PRIu64 "                                         |\n", S.cube_failed);
+                printf("|  Lookaheads:           %12" PRIu64 "                                         |\n", S.lookaheads);
+                printf("|  Cube time:            %12.2f s                                       |\n", cubed_time - parsed_time);
+                printf("|                                                                             |\n"); }
+            if (loaded && icnf != NULL){
+                S.toICNF((const char*)icnf, cubes);
+                exit(0); }
+        }
+        loaded = loaded && P.load(S);
+
+        if (!loaded){
+            if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
+            if (verb > 0){
+                printf("===============================================================================\n");
+                printf("Solved by unit propagation\n\n"); }
+            printf("UNSATISFIABLE\n");
+            exit(20);
+        }
+
+        // Change to signal-handlers that will only notify the solvers and allow them to terminate
+        // voluntarily:
+        sigTerm(SIGINT_interrupt);
+
+        lbool ret = use_cubes ? P.solve(cubes) : P.solve();
+        if (verb > 0){
+            P.printStats();
+            if (use_cubes)
+                printf("Refuted cubes         : %d / %d\n", P.nRefuted(), cubes.size());
+            printf("Winner                : %d\n", P.winner);
+            printf("Wall time             : %g s\n", wallTime() - initial_time);
+            printf("CPU time              : %g s\n\n", cpuTime()); }
+        printf(ret == l_True ? "SATISFIABLE\n" : ret == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
+        if (res != NULL){
+            if (ret == l_True){
+                fprintf(res, "SAT\n");
+                for (int i = 0; i < P.model.size(); i++)
+                    if (P.model[i] != l_Undef)
+                        fprintf(res, "%s%s%d", (i==0)?"":" ", (P.model[i]==l_True)?"":"-", i+1);
+                fprintf(res, " 0\n");
+            }else if (ret == l_False)
+                fprintf(res, "UNSAT\n");
+            else
+                fprintf(res, "INDET\n");
+            fclose(res);
+        }
+
+        // (Exit without running the destructors of the solvers.)
+        exit(ret == l_True ? 10 : ret == l_False ? 20 : 0);
+    } catch (OutOfMemoryException&){
+        printf("===============================================================================\n");
+        printf("INDETERMINATE\n");
+        exit(0);
+    }
+}
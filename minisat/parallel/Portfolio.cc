@@ -0,0 +1,337 @@
+/***********************************************************************************[Portfolio.cc]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <thread>
+
+#include "minisat/parallel/Portfolio.h"
+#include "minisat/utils/Options.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Options:
+
+
+static const char* _cat = "PARALLEL";
+
+static IntOption     opt_share_lbd         (_cat, "share-lbd",   "Share learnt clauses with an LBD of at most this value", 2, IntRange(0, INT32_MAX));
+static IntOption     opt_share_size        (_cat, "share-size",  "Share learnt clauses with at most this many literals", 8, IntRange(0, ClauseBuffer::max_size));
+static IntOption     opt_buffer_size       (_cat, "share-buf",   "Size of the clause buffer of each worker (log2 of the number of literals)", 20, IntRange(12, 30));
+
+
+//=================================================================================================
+// ClauseBuffer:
+
+
+ClauseBuffer::ClauseBuffer(int log_capacity) : mask(((uint64_t)1 << log_capacity) - 1), head(0), reserved(0)
+{
+    data = new std::atomic<uint32_t>[mask + 1];
+    for (uint64_t i = 0; i <= mask; i++)
+        data[i].store(0, std::memory_order_relaxed);
+}
+
+
+ClauseBuffer::~ClauseBuffer() { delete [] data; }
+
+
+void ClauseBuffer::push(const vec<Lit>& c, int lbd)
+{
+    if (c.size() > max_size) return;
+
+    // Announce the region about to be overwritten before writing it, so that readers can tell if
+    // a clause changed while they copied it:
+    uint64_t h = head.load(std::memory_order_relaxed);
+    reserved.store(h + c.size() + 2, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    data[ h      & mask].store(c.size(), std::memory_order_relaxed);
+    data[(h + 1) & mask].store(lbd,      std::memory_order_relaxed);
+    for (int i = 0; i < c.size(); i++)
+        data[(h + 2 + i) & mask].store(toInt(c[i]), std::memory_order_relaxed);
+
+    head.store(h + c.size() + 2, std::memory_order_release);
+}
+
+
+bool ClauseBuffer::read(uint64_t& pos, vec<Lit>& c, int& lbd) const
+{
+    uint64_t h = head.load(std::memory_order_acquire);
+    if (pos >= h) return false;
+
+    uint32_t size = data[pos & mask].load(std::memory_order_relaxed);
+    lbd           = data[(pos + 1) & mask].load(std::memory_order_relaxed);
+    c.clear();
+    for (uint32_t i = 0; i < size && i < (uint32_t)max_size; i++)
+        c.push(toLit(data[(pos + 2 + i) & mask].load(std::memory_order_relaxed)));
+
+    // If the writer may have overwritten any of this, skip to the end:
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (h - pos > mask + 1 || reserved.load(std::memory_order_relaxed) - pos > mask + 1 || size > (uint32_t)max_size){
+        pos = h;
+        return false; }
+
+    pos += size + 2;
+    return true;
+}
+
+
+//=================================================================================================
+// PortfolioWorker:
+
+
+PortfolioWorker::PortfolioWorker(Portfolio& p, int _id) :
+    exported(0), imported(0), portfolio(p), id(_id) {}
+
+
+void PortfolioWorker::exportLearnt(const vec<Lit>& c, int lbd)
+{
+    if (c.size() <= portfolio.share_size || lbd <= portfolio.share_lbd){
+        portfolio.buffers[id]->push(c, lbd);
+        exported++; }
+}
+
+
+// Add the clauses learnt by the other workers since the last call. Literals false at the top level
+// are dropped, and satisfied clauses are skipped. Returns FALSE if the clause set was found to be
+// unsatisfiable.
+bool PortfolioWorker::inprocess()
+{
+    assert(decisionLevel() == 0);
+    read_pos.growTo(portfolio.nWorkers(), 0);
+
+    int lbd;
+    for (int w = 0; w < portfolio.nWorkers(); w++){
+        if (w == id) continue;
+        while (portfolio.buffers[w]->read(read_pos[w], import_tmp, lbd)){
+            int i, j;
+            for (i = j = 0; i < import_tmp.size(); i++)
+                if (value(import_tmp[i]) == l_True)
+                    break;
+                else if (value(import_tmp[i]) == l_Undef)
+                    import_tmp[j++] = import_tmp[i];
+            if (i < import_tmp.size()) continue;
+            import_tmp.shrink(i - j);
+            imported++;
+
+            if (import_tmp.size() == 0)
+                return ok = false;
+            else if (import_tmp.size() == 1)
+                uncheckedEnqueue(import_tmp[0]);
+            else{
+                CRef cr = ca.alloc(import_tmp, true);
+                ca[cr].lbd(lbd < import_tmp.size() ? lbd : import_tmp.size());
+                learnts.push(cr);
+                attachClause(cr);
+            }
+        }
+    }
+
+    return ok = propagate() == CRef_Undef;
+}
+
+
+//=================================================================================================
+// Portfolio:
+
+
+Portfolio::Portfolio(int n_workers) :
+    verbosity (0)
+  , share_lbd (opt_share_lbd)
+  , share_size(opt_share_size)
+  , winner    (-1)
+  , first     (-1)
+  , cubes     (NULL)
+  , next_cube (0)
+  , refuted   (0)
+{
+    for (int i = 0; i < n_workers; i++){
+        workers.push(new PortfolioWorker(*this, i));
+        buffers.push(new ClauseBuffer(opt_buffer_size));
+        diversify(*workers[i], i);
+    }
+}
+
+
+Portfolio::~Portfolio()
+{
+    for (int i = 0; i < workers.size(); i++){
+        delete workers[i];
+        delete buffers[i]; }
+}
+
+
+// Worker 0 uses the options as given. The others get their own random seed and random initial
+// activities, and alternate the restart policy and the phase selection:
+void Portfolio::diversify(Solver& S, int i)
+{
+    if (i == 0) return;
+
+    S.random_seed  = 91648253 + 7919 * i;
+    S.rnd_init_act = true;
+    if (i % 2 == 1)
+        S.ema_restart = !S.ema_restart;
+    switch (i % 4){
+    case 2: S.rnd_pol = true;      break;
+    case 3: S.phase_saving = 1;    break;
+    default: break; }
+    if (i % 8 >= 4)
+        S.vmtf = !S.vmtf;
+}
+
+
+bool Portfolio::load(const Solver& S)
+{
+    vec<Lit> lits;
+    for (int i = 0; i < workers.size(); i++){
+        Solver& W = *workers[i];
+        while (W.nVars() < S.nVars())
+            W.newVar();
+        for (TrailIterator t = S.trailBegin(); t != S.trailEnd(); ++t)
+            W.addClause(*t);
+        if (S.nClauses() > 0)
+            for (ClauseIterator c = S.clausesBegin(); c != S.clausesEnd(); ++c){
+                lits.clear();
+                for (int k = 0; k < (*c).size(); k++)
+                    lits.push((*c)[k]);
+                W.addClause(lits);
+            }
+        if (!W.okay())
+            return false;
+    }
+    return S.okay();
+}
+
+
+void Portfolio::finish(int i)
+{
+    int none = -1;
+    if (first.compare_exchange_strong(none, i))
+        for (int j = 0; j < workers.size(); j++)
+            if (j != i)
+                workers[j]->interrupt();
+}
+
+
+void Portfolio::run(int i)
+{
+    vec<Lit> dummy;
+    results[i] = workers[i]->solveLimited(dummy);
+
+    // The first worker with an answer stops the others:
+    if (results[i] != l_Undef)
+        finish(i);
+}
+
+
+// Solve cubes until they run out, or one is satisfiable. The workers keep their learnt clauses
+// from one cube to the next (they do not depend on the assumptions), and keep sharing them.
+void Portfolio::runCubes(int i)
+{
+    PortfolioWorker& W = *workers[i];
+    int k;
+    while (first == -1 && (k = next_cube++) < cubes->size()){
+        lbool ret = W.solveLimited((*cubes)[k]);
+        if (ret == l_Undef)
+            break;
+        else if (ret == l_True || W.conflict.size() == 0){
+            // Satisfiable, or unsatisfiable without assumptions:
+            results[i] = ret;
+            finish(i);
+        }else
+            refuted++;
+    }
+}
+
+
+lbool Portfolio::runAll()
+{
+    for (int i = 0; i < workers.size(); i++)
+        workers[i]->verbosity = i == 0 && cubes == NULL ? verbosity : 0;
+    results.clear();
+    results.growTo(workers.size(), l_Undef);
+    first = -1;
+
+    vec<std::thread*> threads;
+    for (int i = 0; i < workers.size(); i++)
+        threads.push(new std::thread(cubes == NULL ? &Portfolio::run : &Portfolio::runCubes, this, i));
+    for (int i = 0; i < threads.size(); i++){
+        threads[i]->join();
+        delete threads[i]; }
+
+    winner = first.load();
+    if (winner == -1)
+        return l_Undef;
+
+    if (results[winner] == l_True)
+        workers[winner]->model.copyTo(model);
+    return results[winner];
+}
+
+
+lbool Portfolio::solve()
+{
+    cubes = NULL;
+    return runAll();
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  solve : (cubes : const vec<vec<Lit> >&)  ->  [lbool]
+|
+|  Description:
+|    Conquer phase of cube-and-conquer: the workers take the cubes in order and solve each one
+|    under its literals as assumptions. Returns 'l_True' as soon as a cube is satisfiable, and
+|    'l_False' when all of them are refuted (so the cubes must cover all the models, as those of
+|    'Cuber::cube()' do).
+|________________________________________________________________________________________________@*/
+lbool Portfolio::solve(const vec<vec<Lit> >& cs)
+{
+    cubes     = &cs;
+    next_cube = 0;
+    refuted   = 0;
+    lbool ret = runAll();
+    cubes     = NULL;
+
+    if (ret == l_Undef && refuted == cs.size())
+        ret = l_False;
+    return ret;
+}
+
+
+void Portfolio::interrupt()
+{
+    for (int i = 0; i < workers.size(); i++)
+        workers[i]->interrupt();
+}
+
+
+void Portfolio::printStats() const
+{
+    printf("============================[ Portfolio Statistics ]===========================\n");
+    printf("| Worker |   Conflicts |  Propagations |   Exported |   Imported |   Restarts |\n");
+    printf("===============================================================================\n");
+    for (int i = 0; i < workers.size(); i++){
+        const PortfolioWorker& W = *workers[i];
+        printf("| %5d%c | %11" PRIu64 " | %13" PRIu64 " | %10" PRIu64 " | %10" PRIu64 " | %10" PRIu64 " |\n",
+               i, i == winner ? '*' : ' ', W.conflicts, W.propagations, W.exported, W.imported, W.starts);
+    }
+    printf("===============================================================================\n");
+}
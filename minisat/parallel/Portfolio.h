@@ -0,0 +1,130 @@
+/************************************************************************************[Portfolio.h]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_Portfolio_h
+#define Minisat_Portfolio_h
+
+#include <atomic>
+
+#include "minisat/core/Solver.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// ClauseBuffer -- a lock-free ring buffer of clauses with one writer and any number of readers:
+//
+// Each clause is stored as its size, its LBD and its literals. Every reader keeps its own position
+// in the buffer. A reader that falls more than the capacity behind skips to the current end, and
+// loses the clauses in between.
+
+class ClauseBuffer {
+    std::atomic<uint32_t>* data;
+    uint64_t               mask;
+    std::atomic<uint64_t>  head;      // End of the last published clause.
+    std::atomic<uint64_t>  reserved;  // End of the clause being written (overwrites may happen below this + capacity).
+
+    ClauseBuffer(const ClauseBuffer&);
+    ClauseBuffer& operator=(const ClauseBuffer&);
+
+public:
+    enum { max_size = 1024 };         // Longer clauses are not stored.
+
+    explicit ClauseBuffer(int log_capacity);
+    ~ClauseBuffer();
+
+    void     push(const vec<Lit>& c, int lbd);                // (writer only)
+    bool     read(uint64_t& pos, vec<Lit>& c, int& lbd) const; // Read the clause at 'pos' (if any) and advance 'pos'.
+    uint64_t end () const { return head.load(std::memory_order_acquire); }
+};
+
+
+//=================================================================================================
+// Portfolio -- run diversified copies of 'Solver' in threads, sharing short learnt clauses:
+
+class Portfolio;
+
+class PortfolioWorker : public Solver {
+public:
+    PortfolioWorker(Portfolio& p, int id);
+
+    uint64_t exported, imported;
+
+protected:
+    Portfolio&       portfolio;
+    int              id;
+    vec<uint64_t>    read_pos;     // Position in the buffer of every other worker.
+    vec<Lit>         import_tmp;
+
+    bool inprocess   ();           // Import the clauses shared by the other workers.
+    void exportLearnt(const vec<Lit>& c, int lbd);
+
+    friend class Portfolio;
+};
+
+
+class Portfolio {
+public:
+    explicit Portfolio(int n_workers);
+    ~Portfolio();
+
+    bool    load      (const Solver& S);  // Copy the variables, clauses and top-level units of 'S' to all workers.
+    lbool   solve     ();                 // Run all workers until the first one has an answer.
+    lbool   solve     (const vec<vec<Lit> >& cubes);  // Let the workers take turns solving the cubes until one is satisfiable.
+    void    interrupt ();                 // Stop all workers (may be called asynchronously).
+
+    int     nWorkers  ()      const { return workers.size(); }
+    int     nRefuted  ()      const { return refuted; }
+    Solver& worker    (int i)       { return *workers[i]; }
+    void    printStats()      const;
+
+    // Mode of operation:
+    //
+    int       verbosity;
+    int       share_lbd;    // Share learnt clauses with an LBD of at most this value.
+    int       share_size;   // Share learnt clauses with at most this many literals.
+
+    // Result: (read-only member variables)
+    //
+    int        winner;      // The worker that found the answer (-1 if none).
+    vec<lbool> model;       // If the problem is satisfiable, the model found by 'winner'.
+
+protected:
+    vec<PortfolioWorker*> workers;
+    vec<ClauseBuffer*>    buffers;       // One per worker, written by that worker only.
+    vec<lbool>            results;       // The result of every worker (l_Undef if interrupted).
+    std::atomic<int>      first;         // The first worker to finish (-1 while searching).
+
+    const vec<vec<Lit> >* cubes;         // The cubes to conquer (NULL if solving the whole problem).
+    std::atomic<int>      next_cube;     // The next cube to hand out.
+    std::atomic<int>      refuted;       // The number of cubes shown unsatisfiable.
+
+    void diversify(Solver& S, int i);
+    void run      (int i);
+    void runCubes (int i);
+    void finish   (int i);               // Worker 'i' has the answer: stop the others.
+    lbool runAll  ();
+
+    friend class PortfolioWorker;
+};
+
+//=================================================================================================
+}
+
+#endif
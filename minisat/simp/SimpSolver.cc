@@ -18,6 +18,9 @@ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
 OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 **************************************************************************************************/
 
+#include <atomic>
+#include <thread>
+
 #include "minisat/mtl/Sort.h"
 #include "minisat/simp/SimpSolver.h"
 #include "minisat/utils/System.h"
@@ -33,10 +36,24 @@ static const char* _cat = "SIMP";
 static BoolOption   opt_use_asymm        (_cat, "asymm",        "Shrink clauses by asymmetric branching.", false);
 static BoolOption   opt_use_rcheck       (_cat, "rcheck",       "Check if a clause is already implied. (costly)", false);
 static BoolOption   opt_use_elim         (_cat, "elim",         "Perform variable elimination.", true);
+static BoolOption   opt_use_bce          (_cat, "bce",          "Remove blocked clauses.", true);
+static IntOption    opt_bce_lim          (_cat, "bce-lim",      "Do not look for clauses blocked on a literal whose negation occurs more often than this. -1 means no limit.", 100, IntRange(-1, INT32_MAX));
+static BoolOption   opt_use_gates        (_cat, "gates",        "Use AND, XOR, ITE and equivalence gate definitions to reduce the resolvents of variable elimination.", true);
+static BoolOption   opt_use_bva          (_cat, "bva",          "Replace clause patterns by fewer clauses over new variables (bounded variable addition).", true);
+static IntOption    opt_bva_min          (_cat, "bva-min",      "Only replace a clause pattern by bounded variable addition if it saves at least this many clauses.", 8, IntRange(1, INT32_MAX));
+static IntOption    opt_bva_lim          (_cat, "bva-lim",      "Limit on the clauses visited by bounded variable addition. -1 means no limit.", 100000000, IntRange(-1, INT32_MAX));
 static IntOption    opt_grow             (_cat, "grow",         "Allow a variable elimination step to grow by a number of clauses.", 0);
 static IntOption    opt_clause_lim       (_cat, "cl-lim",       "Variables are not eliminated if it produces a resolvent with a length above this limit. -1 means no limit", 20,   IntRange(-1, INT32_MAX));
 static IntOption    opt_subsumption_lim  (_cat, "sub-lim",      "Do not check if subsumption against a clause larger than this. -1 means no limit.", 1000, IntRange(-1, INT32_MAX));
+static IntOption    opt_sub_threads      (_cat, "sub-threads",  "Number of threads for backward subsumption of large queues (0 = one per hardware thread).", 0, IntRange(0, 1024));
+static IntOption    opt_sub_par_min      (_cat, "sub-par-min",  "Check the subsumption queue in parallel when it holds at least this many clauses. -1 means never.", 100000, IntRange(-1, INT32_MAX));
 static DoubleOption opt_simp_garbage_frac(_cat, "simp-gc-frac", "The fraction of wasted memory allowed before a garbage collection is triggered during simplification.",  0.5, DoubleRange(0, false, HUGE_VAL, false));
+static BoolOption   opt_use_equiv        (_cat, "equiv",        "Substitute equivalent literals found as cycles of binary clauses.", true);
+static IntOption    opt_transred_lim     (_cat, "tr-lim",       "Limit on the implications followed by transitive reduction of binary clauses. -1 means no limit.", 20000000, IntRange(-1, INT32_MAX));
+static IntOption    opt_probe_lim        (_cat, "probe-lim",    "Limit on the propagations of failed literal probing before elimination. 0 means no probing.", 10000000, IntRange(0, INT32_MAX));
+static BoolOption   opt_inproc_elim      (_cat, "inproc-elim",  "Repeat variable elimination on variables that lost occurrences, between restarts.", false);
+static IntOption    opt_inproc_interval  (_cat, "inproc-int",   "Minimum number of conflicts between two rounds of re-elimination.", 10000, IntRange(1, INT32_MAX));
+static DoubleOption opt_inproc_eff       (_cat, "inproc-eff",   "Work allowed in a round of re-elimination, relative to the propagations of the search.", 0.05, DoubleRange(0, false, HUGE_VAL, false));
 
 
 //=================================================================================================
@@ -47,25 +64,52 @@ SimpSolver::SimpSolver() :
     grow               (opt_grow)
   , clause_lim         (opt_clause_lim)
   , subsumption_lim    (opt_subsumption_lim)
+  , sub_threads        (opt_sub_threads)
+  , sub_par_min        (opt_sub_par_min)
   , simp_garbage_frac  (opt_simp_garbage_frac)
   , use_asymm          (opt_use_asymm)
   , use_rcheck         (opt_use_rcheck)
   , use_elim           (opt_use_elim)
+  , use_bce            (opt_use_bce)
+  , use_gates          (opt_use_gates)
+  , bce_lim            (opt_bce_lim)
+  , use_equiv          (opt_use_equiv)
+  , transred_lim       (opt_transred_lim)
+  , probe_lim          (opt_probe_lim)
+  , use_bva            (opt_use_bva)
+  , bva_min            (opt_bva_min)
+  , bva_lim            (opt_bva_lim)
   , extend_model       (true)
+  , use_inproc_elim    (opt_inproc_elim)
+  , inproc_interval    (opt_inproc_interval)
+  , inproc_eff         (opt_inproc_eff)
   , merges             (0)
   , asymm_lits         (0)
   , eliminated_vars    (0)
+  , blocked_clauses    (0)
+  , bva_vars           (0)
+  , bva_saved          (0)
+  , substituted_vars   (0)
+  , transred_bins      (0)
+  , inproc_rounds      (0)
   , elimorder          (1)
   , use_simplification (true)
   , occurs             (ClauseDeleted(ca))
   , elim_heap          (ElimLt(n_occ))
   , bwdsub_assigns     (0)
   , n_touched          (0)
+  , next_inproc        (inproc_interval)
+  , inproc_props       (0)
+  , simp_ticks         (0)
+  , simp_budget        (-1)
 {
     vec<Lit> dummy(1,lit_Undef);
     ca.extra_clause_field = true; // NOTE: must happen before allocating the dummy clause below.
     bwdsub_tmpunit        = ca.alloc(dummy);
     remove_satisfied      = false;
+
+    for (int i = 0; i < 4; i++)
+        gate_vars[i] = 0, gate_saved[i] = 0;
 }
 
 
@@ -77,8 +121,9 @@ SimpSolver::~SimpSolver()
 Var SimpSolver::newVar(lbool upol, bool dvar) {
     Var v = Solver::newVar(upol, dvar);
 
-    frozen    .insert(v, (char)false);
-    eliminated.insert(v, (char)false);
+    frozen     .insert(v, (char)false);
+    eliminated .insert(v, (char)false);
+    occ_partial.insert(v, (char)false);
 
     if (use_simplification){
         n_occ     .insert( mkLit(v), 0);
@@ -110,7 +155,7 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
 
     do_simp &= use_simplification;
 
-    if (do_simp){
+    if (do_simp || use_inproc_elim){
         // Assumptions must be temporarily frozen to run variable elimination:
         for (int i = 0; i < assumptions.size(); i++){
             Var v = var(assumptions[i]);
@@ -124,7 +169,8 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
                 extra_frozen.push(v);
             } }
 
-        result = lbool(eliminate(turn_off_simp));
+        if (do_simp)
+            result = lbool(eliminate(turn_off_simp));
     }
 
     if (result == l_True)
@@ -135,7 +181,7 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
     if (result == l_True && extend_model)
         extendModel();
 
-    if (do_simp)
+    if (do_simp || use_inproc_elim)
         // Unfreeze the assumptions that were frozen:
         for (int i = 0; i < extra_frozen.size(); i++)
             setFrozen(extra_frozen[i], false);
@@ -185,6 +231,55 @@ bool SimpSolver::addClause_(vec<Lit>& ps)
 }
 
 
+bool SimpSolver::addClauses(const uint32_t* sizes, const uint32_t* lits, uint64_t n_clauses)
+{
+#ifndef NDEBUG
+    for (uint64_t i = 0, n = 0; i < n_clauses; n += sizes[i++])
+        for (uint32_t k = 0; k < sizes[i]; k++)
+            assert(!isEliminated(var(toLit(lits[n + k]))));
+#endif
+
+    // Redundancy checks need the clauses one at a time:
+    if (use_rcheck){
+        for (uint64_t i = 0; i < n_clauses; lits += sizes[i++]){
+            add_tmp.clear();
+            for (uint32_t k = 0; k < sizes[i]; k++)
+                add_tmp.push(toLit(lits[k]));
+            if (!addClause_(add_tmp))
+                return false;
+        }
+        return true;
+    }
+
+    int  nclauses = clauses.size();
+    bool ret      = Solver::addClauses(sizes, lits, n_clauses);
+    if (use_simplification)
+        registerClauses(nclauses);
+
+    return ret;
+}
+
+
+// Register clauses added to 'clauses' behind the back of 'addClause_()', as it does:
+void SimpSolver::registerClauses(int from)
+{
+    assert(use_simplification);
+    for (int j = from; j < clauses.size(); j++){
+        CRef          cr = clauses[j];
+        const Clause& c  = ca[cr];
+        subsumption_queue.insert(cr);
+        for (int i = 0; i < c.size(); i++){
+            occurs[var(c[i])].push(cr);
+            n_occ[c[i]]++;
+            touched[var(c[i])] = 1;
+            n_touched++;
+            if (elim_heap.inHeap(var(c[i])))
+                elim_heap.increase(var(c[i]));
+        }
+    }
+}
+
+
 void SimpSolver::removeClause(CRef cr)
 {
     const Clause& c = ca[cr];
@@ -217,7 +312,8 @@ bool SimpSolver::strengthenClause(CRef cr, Lit l)
         detachClause(cr, true);
         c.strengthen(l);
         attachClause(cr);
-        remove(occurs[var(l)], cr);
+        if (!occ_partial[var(l)])
+            remove(occurs[var(l)], cr);
         n_occ[l]--;
         updateElimHeap(var(l));
     }
@@ -230,6 +326,7 @@ bool SimpSolver::strengthenClause(CRef cr, Lit l)
 bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause)
 {
     merges++;
+    simp_ticks++;
     out_clause.clear();
 
     bool  ps_smallest = _ps.size() < _qs.size();
@@ -262,6 +359,7 @@ bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& ou
 bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
 {
     merges++;
+    simp_ticks++;
 
     bool  ps_smallest = _ps.size() < _qs.size();
     const Clause& ps  =  ps_smallest ? _qs : _ps;
@@ -337,6 +435,109 @@ bool SimpSolver::implied(const vec<Lit>& c)
 }
 
 
+// Find the candidate pairs of the subsumers in 'cands' in chunks of 'sub_chunk' clauses, taken in
+// turn with the other threads. The pairs '(c, d)' where 'c' may subsume or strengthen 'd' are
+// stored in 'found[chunk]'. Only reads the clause database.
+void SimpSolver::subsumptionWorker(const vec<CRef>& cands, vec<vec<CRef> >& found, std::atomic<int>& next_chunk, std::atomic<uint64_t>& ticks)
+{
+    uint64_t local_ticks = 0;
+    int      chunk;
+    while (!interrupted() && (chunk = next_chunk++) * sub_chunk < cands.size()){
+        vec<CRef>& out = found[chunk];
+        int        end = (chunk + 1) * sub_chunk < cands.size() ? (chunk + 1) * sub_chunk : cands.size();
+
+        for (int i = chunk * sub_chunk; i < end; i++){
+            CRef          cr = cands[i];
+            const Clause& c  = ca[cr];
+
+            Var best = var_Undef;
+            for (int k = 0; k < c.size(); k++)
+                if (!occ_partial[var(c[k])] && (best == var_Undef || occurs[var(c[k])].size() < occurs[best].size()))
+                    best = var(c[k]);
+            if (best == var_Undef) continue;
+
+            const vec<CRef>& cs = occurs[best];
+            for (int j = 0; j < cs.size(); j++)
+                if (!ca[cs[j]].mark() && cs[j] != cr && (subsumption_lim == -1 || ca[cs[j]].size() < subsumption_lim)){
+                    local_ticks++;
+                    if (c.subsumes(ca[cs[j]]) != lit_Error){
+                        out.push(cr);
+                        out.push(cs[j]); }
+                }
+        }
+    }
+    ticks += local_ticks;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  parallelSubsumption : [void]  ->  [bool]
+|
+|  Description:
+|    Backward subsumption and self-subsuming resolution of all clauses in the subsumption queue,
+|    with the search for candidates split over 'sub_threads' threads. The threads only read the
+|    clause database (a snapshot of the queue and the occurrence lists). Their candidate pairs are
+|    then checked again and applied in queue order, so the result does not depend on the number of
+|    threads. Clauses strengthened here are put back in the queue.
+|    Returns FALSE if the clause set was found to be unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool SimpSolver::parallelSubsumption()
+{
+    assert(decisionLevel() == 0);
+
+    // Snapshot the queue, with clean occurrence lists:
+    vec<CRef> cands;
+    for (int i = 0; i < subsumption_queue.size(); i++)
+        if (!ca[subsumption_queue[i]].mark())
+            cands.push(subsumption_queue[i]);
+    subsumption_queue.clear();
+    occurs.cleanAll();
+
+    int n_chunks  = (cands.size() + sub_chunk - 1) / sub_chunk;
+    int n_threads = sub_threads != 0 ? sub_threads : (int)std::thread::hardware_concurrency();
+    if (n_threads < 1)        n_threads = 1;
+    if (n_threads > n_chunks) n_threads = n_chunks;
+
+    vec<vec<CRef> >       found(n_chunks);
+    std::atomic<int>      next_chunk(0);
+    std::atomic<uint64_t> ticks(0);
+    vec<std::thread*>     threads;
+    for (int i = 1; i < n_threads; i++)
+        threads.push(new std::thread(&SimpSolver::subsumptionWorker, this, std::cref(cands), std::ref(found), std::ref(next_chunk), std::ref(ticks)));
+    subsumptionWorker(cands, found, next_chunk, ticks);
+    for (int i = 0; i < threads.size(); i++){
+        threads[i]->join();
+        delete threads[i]; }
+    simp_ticks += ticks;
+
+    if (interrupted())
+        return true;
+
+    // Apply the pairs in order. Earlier steps may have removed or strengthened either clause:
+    int subsumed = 0, deleted_literals = 0;
+    for (int i = 0; i < n_chunks; i++)
+        for (int j = 0; j < found[i].size(); j += 2){
+            CRef cr = found[i][j], dr = found[i][j+1];
+            if (ca[cr].mark() || ca[dr].mark()) continue;
+
+            Lit l = ca[cr].subsumes(ca[dr]);
+            if (l == lit_Undef)
+                subsumed++, removeClause(dr);
+            else if (l != lit_Error){
+                deleted_literals++;
+                if (!strengthenClause(dr, ~l))
+                    return false;
+            }
+        }
+
+    if (verbosity >= 2)
+        printf("|  Parallel subsumption: %10d clauses (%d threads), %8d subsumed, %8d deleted literals\n",
+               cands.size(), n_threads, subsumed, deleted_literals);
+    return true;
+}
+
+
 // Backward subsumption + backward subsumption resolution
 bool SimpSolver::backwardSubsumptionCheck(bool verbose)
 {
@@ -345,10 +546,15 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
     int deleted_literals = 0;
     assert(decisionLevel() == 0);
 
+    // Large queues are checked in parallel first (but not with a budget, which would make the
+    // result depend on the timing of the threads):
+    if (sub_par_min >= 0 && subsumption_queue.size() >= sub_par_min && simp_budget < 0 && !parallelSubsumption())
+        return false;
+
     while (subsumption_queue.size() > 0 || bwdsub_assigns < trail.size()){
 
-        // Empty subsumption queue and return immediately on user-interrupt:
-        if (asynch_interrupt){
+        // Empty subsumption queue and return immediately on user-interrupt (or when out of budget):
+        if (interrupted() || !withinSimpBudget()){
             subsumption_queue.clear();
             bwdsub_assigns = trail.size();
             break; }
@@ -370,11 +576,12 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
 
         assert(c.size() > 1 || value(c[0]) == l_True);    // Unit-clauses should have been propagated before this point.
 
-        // Find best variable to scan:
-        Var best = var(c[0]);
-        for (int i = 1; i < c.size(); i++)
-            if (occurs[var(c[i])].size() < occurs[best].size())
+        // Find best variable to scan (it must have a complete occurrence list):
+        Var best = var_Undef;
+        for (int i = 0; i < c.size(); i++)
+            if (!occ_partial[var(c[i])] && (best == var_Undef || occurs[var(c[i])].size() < occurs[best].size()))
                 best = var(c[i]);
+        if (best == var_Undef) continue;
 
         // Search all candidates:
         vec<CRef>& _cs = occurs.lookup(best);
@@ -384,6 +591,7 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
             if (c.mark())
                 break;
             else if (!ca[cs[j]].mark() &&  cs[j] != cr && (subsumption_lim == -1 || ca[cs[j]].size() < subsumption_lim)){
+                simp_ticks++;
                 Lit l = c.subsumes(ca[cs[j]]);
 
                 if (l == lit_Undef)
@@ -456,6 +664,18 @@ static void mkElimClause(vec<uint32_t>& elimclauses, Lit x)
 }
 
 
+// Store 'v == x' as the clauses (v | ~x) and (~v | x):
+static void mkEquivElimClauses(vec<uint32_t>& elimclauses, Var v, Lit x)
+{
+    elimclauses.push(toInt( mkLit(v)));
+    elimclauses.push(toInt(~x));
+    elimclauses.push(2);
+    elimclauses.push(toInt(~mkLit(v)));
+    elimclauses.push(toInt( x));
+    elimclauses.push(2);
+}
+
+
 static void mkElimClause(vec<uint32_t>& elimclauses, Var v, Clause& c)
 {
     int first = elimclauses.size();
@@ -495,6 +715,14 @@ bool SimpSolver::eliminateVar(Var v)
     for (int i = 0; i < cls.size(); i++)
         (find(ca[cls[i]], mkLit(v)) ? pos : neg).push(cls[i]);
 
+    // If 'v' is defined by a gate, only the resolvents between gate and non-gate clauses are needed.
+    // Resolvents of two gate clauses are tautologies, and those of two non-gate clauses are implied.
+    // The search is skipped if all resolvents fit anyway:
+    //
+    int gate = gate_None;
+    if (use_gates && !(clause_lim == -1 && (int64_t)pos.size() * neg.size() <= cls.size() + grow))
+        gate = findGate(v, pos, neg, pos_gate, neg_gate);
+
     // Check wether the increase in number of clauses stays within the allowed ('grow'). Moreover, no
     // clause must exceed the limit on the maximal clause size (if it is set):
     //
@@ -503,7 +731,8 @@ bool SimpSolver::eliminateVar(Var v)
 
     for (int i = 0; i < pos.size(); i++)
         for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, clause_size) && 
+            if ((gate == gate_None || pos_gate[i] != neg_gate[j]) &&
+                merge(ca[pos[i]], ca[neg[j]], v, clause_size) && 
                 (++cnt > cls.size() + grow || (clause_lim != -1 && clause_size > clause_lim)))
                 return true;
 
@@ -511,6 +740,13 @@ bool SimpSolver::eliminateVar(Var v)
     eliminated[v] = true;
     setDecisionVar(v, false);
     eliminated_vars++;
+    if (gate != gate_None){
+        int n_pos = 0, n_neg = 0;
+        for (int i = 0; i < pos.size(); i++) n_pos += !pos_gate[i];
+        for (int i = 0; i < neg.size(); i++) n_neg += !neg_gate[i];
+        gate_vars [gate]++;
+        gate_saved[gate] += (int64_t)n_pos * n_neg;
+    }
 
     if (pos.size() > neg.size()){
         for (int i = 0; i < neg.size(); i++)
@@ -529,7 +765,8 @@ bool SimpSolver::eliminateVar(Var v)
     vec<Lit>& resolvent = add_tmp;
     for (int i = 0; i < pos.size(); i++)
         for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addClause_(resolvent))
+            if ((gate == gate_None || pos_gate[i] != neg_gate[j]) &&
+                merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addClause_(resolvent))
                 return false;
 
     // Free occurs list for this variable:
@@ -538,11 +775,373 @@ bool SimpSolver::eliminateVar(Var v)
     // Free watchers lists for this variable, if possible:
     if (watches[ mkLit(v)].size() == 0) watches[ mkLit(v)].clear(true);
     if (watches[~mkLit(v)].size() == 0) watches[~mkLit(v)].clear(true);
+    if (watches_bin[ mkLit(v)].size() == 0) watches_bin[ mkLit(v)].clear(true);
+    if (watches_bin[~mkLit(v)].size() == 0) watches_bin[~mkLit(v)].clear(true);
+    if (watches_tern[ mkLit(v)].size() == 0) watches_tern[ mkLit(v)].clear(true);
+    if (watches_tern[~mkLit(v)].size() == 0) watches_tern[~mkLit(v)].clear(true);
 
     return backwardSubsumptionCheck();
 }
 
 
+// Find the clause with exactly the literals 'a', 'b' and 'c' in 'cs'. Returns its index, or -1.
+static int findTernary(const ClauseAllocator& ca, const vec<CRef>& cs, Lit a, Lit b, Lit c)
+{
+    for (int i = 0; i < cs.size(); i++){
+        const Clause& d = ca[cs[i]];
+        if (d.size() == 3 && find(d, a) && find(d, b) && find(d, c))
+            return i;
+    }
+    return -1;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  findGate : (v : Var) (pos neg : const vec<CRef>&) (pos_gate neg_gate : vec<char>&)  ->  [int]
+|  
+|  Description:
+|    Look for a definition 'v = f(...)' among the clauses 'pos' (with 'v') and 'neg' (with '~v').
+|    The gate types are tried in order:
+|      * AND:  '(~p | a_i)' for all i, and '(p | ~a_1 | ... | ~a_k)', with 'p' either 'v' or '~v'
+|              (so this includes OR gates). For k = 1, this is an equivalence (EQV).
+|      * XOR:  'v = a ^ b' as four ternary clauses.
+|      * ITE:  'v = c ? t : e' as four ternary clauses.
+|    The clauses of the definition are flagged in 'pos_gate' and 'neg_gate'. Returns the type of
+|    the gate, or 'gate_None'. XOR and ITE gates are only searched for among the first 64 ternary
+|    clauses of each sign, as the search is quadratic (ITE) in their number.
+|________________________________________________________________________________________________@*/
+int SimpSolver::findGate(Var v, const vec<CRef>& pos, const vec<CRef>& neg, vec<char>& pos_gate, vec<char>& neg_gate)
+{
+    pos_gate.clear(); pos_gate.growTo(pos.size(), 0);
+    neg_gate.clear(); neg_gate.growTo(neg.size(), 0);
+    gate_seen.growTo(2*nVars(), 0);
+
+    // AND (and EQV): mark the literals implied by 'p' through binary clauses, then look for a clause
+    // with 'p' where all other literals are negations of marked literals:
+    for (int s = 0; s < 2; s++){
+        Lit               p          = mkLit(v, s);
+        const vec<CRef>&  bins       = s ? pos : neg;
+        const vec<CRef>&  longs      = s ? neg : pos;
+        vec<char>&        bins_gate  = s ? pos_gate : neg_gate;
+        vec<char>&        longs_gate = s ? neg_gate : pos_gate;
+
+        for (int i = 0; i < bins.size(); i++){
+            const Clause& c = ca[bins[i]];
+            if (c.size() == 2)
+                gate_seen[toInt(c[0] == ~p ? c[1] : c[0])] = 1;
+        }
+
+        int found = -1;
+        for (int i = 0; i < longs.size() && found == -1; i++){
+            const Clause& c = ca[longs[i]];
+            int k;
+            for (k = 0; k < c.size() && (c[k] == p || gate_seen[toInt(~c[k])]); k++);
+            if (k == c.size())
+                found = i;
+        }
+
+        if (found != -1){
+            const Clause& c = ca[longs[found]];
+            longs_gate[found] = 1;
+            for (int k = 0; k < c.size(); k++)
+                if (c[k] != p)
+                    gate_seen[toInt(~c[k])] = 2;
+            for (int i = 0; i < bins.size(); i++){
+                const Clause& b = ca[bins[i]];
+                if (b.size() == 2){
+                    Lit a = b[0] == ~p ? b[1] : b[0];
+                    if (gate_seen[toInt(a)] == 2){
+                        bins_gate[i] = 1;
+                        gate_seen[toInt(a)] = 1; }   // (only one clause per input, in case of duplicates)
+                }
+            }
+        }
+
+        for (int i = 0; i < bins.size(); i++){
+            const Clause& c = ca[bins[i]];
+            if (c.size() == 2)
+                gate_seen[toInt(c[0] == ~p ? c[1] : c[0])] = 0;
+        }
+
+        if (found != -1)
+            return ca[longs[found]].size() == 2 ? gate_Equiv : gate_And;
+    }
+
+    // Collect the ternary clauses:
+    vec<int> pos3, neg3;
+    for (int i = 0; i < pos.size() && pos3.size() < 64; i++) if (ca[pos[i]].size() == 3) pos3.push(i);
+    for (int i = 0; i < neg.size() && neg3.size() < 64; i++) if (ca[neg[i]].size() == 3) neg3.push(i);
+    if (pos3.size() < 2 || neg3.size() < 2)
+        return gate_None;
+
+    // XOR: (v | a | b), (v | ~a | ~b), (~v | ~a | b), (~v | a | ~b):
+    Lit x = mkLit(v);
+    for (int i = 0; i < pos3.size(); i++){
+        const Clause& c = ca[pos[pos3[i]]];
+        Lit a = lit_Undef, b = lit_Undef;
+        for (int k = 0; k < 3; k++)
+            if (c[k] != x) (a == lit_Undef ? a : b) = c[k];
+        int j  = findTernary(ca, pos, x, ~a, ~b);
+        int k1 = findTernary(ca, neg, ~x, ~a, b);
+        int k2 = findTernary(ca, neg, ~x, a, ~b);
+        if (j != -1 && k1 != -1 && k2 != -1){
+            pos_gate[pos3[i]] = pos_gate[j] = 1;
+            neg_gate[k1] = neg_gate[k2] = 1;
+            return gate_Xor; }
+    }
+
+    // ITE: (~v | ~c | t), (~v | c | e), (v | ~c | ~t), (v | c | ~e):
+    for (int i = 0; i < neg3.size(); i++){
+        const Clause& ci = ca[neg[neg3[i]]];
+        for (int j = i+1; j < neg3.size(); j++){
+            const Clause& cj = ca[neg[neg3[j]]];
+            for (int k = 0; k < 3; k++){
+                Lit c = ci[k];
+                if (c == ~x || !find(cj, ~c)) continue;
+                Lit t = lit_Undef, e = lit_Undef;
+                for (int h = 0; h < 3; h++){
+                    if (ci[h] != ~x && ci[h] != c)  t = ci[h];
+                    if (cj[h] != ~x && cj[h] != ~c) e = cj[h]; }
+                if (var(t) == var(e)) continue;
+                int p1 = findTernary(ca, pos, x, c, ~t);
+                int p2 = findTernary(ca, pos, x, ~c, ~e);
+                if (p1 != -1 && p2 != -1){
+                    neg_gate[neg3[i]] = neg_gate[neg3[j]] = 1;
+                    pos_gate[p1] = pos_gate[p2] = 1;
+                    return gate_Ite; }
+            }
+        }
+    }
+
+    return gate_None;
+}
+
+
+// Remove the clauses that are blocked on a literal of 'v': every resolvent on 'v' with a clause
+// containing the opposite literal is a tautology. The removed clauses are stored in 'elimclauses'
+// with the literal of 'v' first, so 'extendModel()' flips 'v' if the model falsifies them. Like
+// elimination, this is only sound if 'v' does not occur in clauses added later, so 'v' must not
+// be frozen.
+void SimpSolver::eliminateBlocked(Var v)
+{
+    assert(!frozen[v]);
+    assert(!isEliminated(v));
+
+    const vec<CRef>& cls = occurs.lookup(v);
+    vec<CRef>        pos, neg;
+    for (int i = 0; i < cls.size(); i++)
+        (find(ca[cls[i]], mkLit(v)) ? pos : neg).push(cls[i]);
+
+    for (int s = 0; s < 2; s++){
+        vec<CRef>& cands = s ? neg : pos;
+        vec<CRef>& opps  = s ? pos : neg;
+        if (bce_lim != -1 && opps.size() > bce_lim) continue;
+
+        int i, j, k, size;
+        for (i = j = 0; i < cands.size(); i++){
+            for (k = 0; k < opps.size(); k++)
+                if (merge(ca[cands[i]], ca[opps[k]], v, size))
+                    break;
+            if (k < opps.size())
+                cands[j++] = cands[i];
+            else{
+                mkElimClause(elimclauses, v, ca[cands[i]]);
+                removeClause(cands[i]);
+                blocked_clauses++;
+            }
+        }
+        cands.shrink(i - j);
+    }
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  boundedVarAddition : ()  ->  [bool]
+|  
+|  Description:
+|    Bounded variable addition (SimpleBVA). Starting from a literal 'l', greedily grow a set of
+|    literals 'Mlit' (containing 'l') and a set of clauses 'Mcls' (all containing 'l') such that
+|    '(C \ {l}) | m' is a clause for every 'C' in 'Mcls' and 'm' in 'Mlit'. This is the pattern
+|    of at-most-one constraints and of products of literal sets. If it saves at least 'bva_min'
+|    clauses, the |Mlit|*|Mcls| clauses are replaced by '(m | x)' for all 'm' and '(C \ {l} | ~x)'
+|    for all 'C', where 'x' is a new variable. Resolving on 'x' gives back the old clauses, so the
+|    clause set is unchanged on the old variables. 'x' is left out of the model again by
+|    'extendModel()'.
+|
+|    Literals are tried in order of decreasing occurrences, and are queued again when a
+|    replacement changes their occurrences. Returns FALSE if the clause set was found to be
+|    unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool SimpSolver::boundedVarAddition()
+{
+    Heap<Lit,BvaLt,MkIndexLit> queue((BvaLt(n_occ)));
+    for (Var v = 0; v < nVars(); v++)
+        if (value(v) == l_Undef && !isEliminated(v))
+            for (int s = 0; s < 2; s++)
+                if (n_occ[mkLit(v, s)] > 1)
+                    queue.insert(mkLit(v, s));
+
+    vec<char> mark(2*nVars(), 0);
+    vec<int>  cnt (2*nVars(), 0);
+    vec<Lit>  mlit, p_lits, tails, ps;
+    vec<CRef> mcls, p_cls;
+    int64_t   steps = 0;
+    int       vars_before = bva_vars, saved_before = bva_saved;
+
+    while (!queue.empty() && (bva_lim == -1 || steps < bva_lim) && !interrupted()){
+        Lit l = queue.removeMin();
+        if (value(l) != l_Undef || isEliminated(var(l)) || n_occ[l] < 2) continue;
+
+        mlit.clear();
+        mcls.clear();
+        mlit.push(l);
+        const vec<CRef>& cls = occurs.lookup(var(l));
+        for (int i = 0; i < cls.size(); i++)
+            if (find(ca[cls[i]], l))
+                mcls.push(cls[i]);
+
+        for (;;){
+            // Find the pairs (m, C) such that '(C \ {l}) | m' is a clause, looking at the
+            // occurrences of the least frequent literal of 'C \ {l}':
+            p_lits.clear();
+            p_cls .clear();
+            for (int i = 0; i < mcls.size(); i++){
+                const Clause& c    = ca[mcls[i]];
+                Lit           lmin = lit_Undef;
+                for (int k = 0; k < c.size(); k++){
+                    mark[toInt(c[k])] = 1;
+                    if (c[k] != l && (lmin == lit_Undef || n_occ[c[k]] < n_occ[lmin]))
+                        lmin = c[k]; }
+
+                const vec<CRef>& ds = occurs.lookup(var(lmin));
+                for (int j = 0; j < ds.size(); j++){
+                    const Clause& d = ca[ds[j]];
+                    steps++;
+                    simp_ticks++;
+                    if (d.size() != c.size() || ds[j] == mcls[i]) continue;
+
+                    Lit m = lit_Undef;
+                    int k;
+                    for (k = 0; k < d.size(); k++)
+                        if (d[k] == l || (!mark[toInt(d[k])] && m != lit_Undef))
+                            break;
+                        else if (!mark[toInt(d[k])])
+                            m = d[k];
+                    if (k < d.size() || m == lit_Undef || m == ~l) continue;
+                    for (k = 0; k < mlit.size() && mlit[k] != m; k++);
+                    if (k < mlit.size() || (p_cls.size() > 0 && p_cls.last() == mcls[i] && p_lits.last() == m))
+                        continue;
+                    p_lits.push(m);
+                    p_cls .push(mcls[i]);
+                }
+
+                for (int k = 0; k < c.size(); k++)
+                    mark[toInt(c[k])] = 0;
+            }
+
+            // Pick the most frequent literal, and stop if adding it does not save more clauses:
+            Lit lmax = lit_Undef;
+            for (int i = 0; i < p_lits.size(); i++)
+                if (++cnt[toInt(p_lits[i])], lmax == lit_Undef || cnt[toInt(p_lits[i])] > cnt[toInt(lmax)])
+                    lmax = p_lits[i];
+            int n_max = lmax == lit_Undef ? 0 : cnt[toInt(lmax)];
+            for (int i = 0; i < p_lits.size(); i++)
+                cnt[toInt(p_lits[i])] = 0;
+
+            int nl = mlit.size(), nc = mcls.size();
+            if ((nl+1)*n_max - (nl+1) - n_max <= nl*nc - nl - nc)
+                break;
+
+            int j = 0;
+            mlit.push(lmax);
+            for (int i = 0; i < p_lits.size(); i++)
+                if (p_lits[i] == lmax)
+                    mcls[j++] = p_cls[i];
+            mcls.shrink(mcls.size() - j);
+        }
+
+        // A replacement saving no more than 'grow' clauses would be undone by elimination:
+        int saved = mlit.size()*mcls.size() - mlit.size() - mcls.size();
+        if (mlit.size() < 2 || saved < bva_min || saved <= grow)
+            continue;
+
+        // Remove the matrix, remembering the tails 'C \ {l}':
+        Var x = newVar();
+        mark.push(0); mark.push(0);
+        cnt .push(0); cnt .push(0);
+        bva_vars++;
+        bva_saved += saved;
+        added_vars.push(x);
+        tails.clear();
+        for (int i = 0; i < mcls.size(); i++){
+            const Clause& c = ca[mcls[i]];
+            for (int k = 0; k < c.size(); k++)
+                if (c[k] != l){
+                    mark[toInt(c[k])] = 1;
+                    tails.push(c[k]); }
+            tails.push(lit_Undef);
+
+            for (int j = 1; j < mlit.size(); j++){
+                const vec<CRef>& ds = occurs.lookup(var(mlit[j]));
+                for (int k = 0; k < ds.size(); k++){
+                    const Clause& d = ca[ds[k]];
+                    int h;
+                    if (d.size() != c.size()) continue;
+                    for (h = 0; h < d.size() && (d[h] == mlit[j] || mark[toInt(d[h])]); h++);
+                    if (h == d.size() && find(d, mlit[j])){
+                        removeClause(ds[k]);
+                        break; }
+                }
+            }
+
+            for (int k = 0; k < c.size(); k++)
+                mark[toInt(c[k])] = 0;
+            removeClause(mcls[i]);
+        }
+
+        // Add the new clauses:
+        for (int i = 0; i < mlit.size(); i++){
+            ps.clear();
+            ps.push(mlit[i]);
+            ps.push(mkLit(x));
+            if (!addClause_(ps))
+                return false;
+        }
+        ps.clear();
+        for (int i = 0; i < tails.size(); i++)
+            if (tails[i] != lit_Undef)
+                ps.push(tails[i]);
+            else{
+                ps.push(~mkLit(x));
+                if (!addClause_(ps))
+                    return false;
+                ps.clear();
+            }
+
+        // Queue the literals with changed occurrences again:
+        tails.push(mkLit(x));
+        tails.push(~mkLit(x));
+        for (int i = 0; i < mlit.size(); i++)
+            tails.push(mlit[i]);
+        for (int i = 0; i < tails.size(); i++)
+            if (tails[i] == lit_Undef)
+                continue;
+            else if (queue.inHeap(tails[i]))
+                queue.update(tails[i]);
+            else if (n_occ[tails[i]] > 1)
+                queue.insert(tails[i]);
+    }
+
+    if (verbosity >= 1 && bva_vars > vars_before)
+        printf("|  Variable addition:  %8d vars added, %8d clauses saved          |\n",
+               bva_vars - vars_before, bva_saved - saved_before);
+
+    return true;
+}
+
+
 bool SimpSolver::substitute(Var v, Lit x)
 {
     assert(!frozen[v]);
@@ -553,6 +1152,7 @@ bool SimpSolver::substitute(Var v, Lit x)
 
     eliminated[v] = true;
     setDecisionVar(v, false);
+    mkEquivElimClauses(elimclauses, v, x);
     const vec<CRef>& cls = occurs.lookup(v);
     
     vec<Lit>& subst_clause = add_tmp;
@@ -575,6 +1175,233 @@ bool SimpSolver::substitute(Var v, Lit x)
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  substituteEquivalences : ()  ->  [bool]
+|  
+|  Description:
+|    Find equivalent literals. These are strongly connected components of the binary implication
+|    graph, where a binary clause (a | b) gives the edges ~a -> b and ~b -> a. The graph is built
+|    from all binary clauses in 'watches_bin', learnt ones included, since they are all implied.
+|    Each component is found with Tarjan's algorithm. The component of the negated literals is
+|    mapped to the negated representative. The representative is a frozen variable if the
+|    component has one, otherwise the smallest variable.
+|
+|    Every other non-frozen variable of the component is replaced by its representative in the
+|    problem clauses. It is then marked as eliminated, and 'v == x' is recorded in 'elimclauses'.
+|    Learnt clauses with a substituted variable are removed. Afterwards, redundant binary
+|    clauses are removed by 'transitiveReduction()'.
+|
+|    Works with or without occurrence lists ('use_simplification'). Without them, as between
+|    restarts, only variables below 'max_simp_var' are considered. Must be called at decision
+|    level 0. Returns FALSE if the clause set was found to be unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool SimpSolver::substituteEquivalences()
+{
+    assert(decisionLevel() == 0);
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+
+    Var      max_var = use_simplification ? nVars() : max_simp_var;
+    int      n_lits  = 2*max_var;
+    vec<int> index(n_lits, -1), low(n_lits, 0);
+    vec<Lit> repr (n_lits, lit_Undef);
+    vec<Lit> stack, dfs, scc;
+    vec<int> dfs_pos;
+    vec<char> vmark(max_var, 0);
+    int      cnt     = 0;
+    int      subst   = 0;
+    int      removed = transred_bins;
+    int      i, j;
+
+    watches_bin.cleanAll();
+    for (int s = 0; s < n_lits; s++){
+        Var sv = var(toLit(s));
+        if (index[s] != -1 || isEliminated(sv) || value(sv) != l_Undef) continue;
+
+        // Iterative depth first search from 's' (Tarjan's algorithm):
+        index[s] = low[s] = cnt++;
+        stack.push(toLit(s));
+        dfs.push(toLit(s));
+        dfs_pos.push(0);
+        while (dfs.size() > 0){
+            Lit                 p  = dfs.last();
+            int&                k  = dfs_pos.last();
+            const vec<Watcher>& ws = watches_bin[p];
+            bool                descended = false;
+
+            for (; k < ws.size(); k++){
+                Lit q = ws[k].blocker;
+                if (var(q) >= max_var || isEliminated(var(q)) || value(q) != l_Undef) continue;
+                if (index[toInt(q)] == -1){
+                    k++;    // (before 'dfs_pos' grows, which may move 'k')
+                    index[toInt(q)] = low[toInt(q)] = cnt++;
+                    stack.push(q);
+                    dfs.push(q);
+                    dfs_pos.push(0);
+                    descended = true;
+                    break;
+                }else if (repr[toInt(q)] == lit_Undef && index[toInt(q)] < low[toInt(p)])
+                    // 'q' is still on the stack:
+                    low[toInt(p)] = index[toInt(q)];
+            }
+            if (descended) continue;
+
+            dfs.pop();
+            dfs_pos.pop();
+            if (dfs.size() > 0 && low[toInt(p)] < low[toInt(dfs.last())])
+                low[toInt(dfs.last())] = low[toInt(p)];
+            if (low[toInt(p)] != index[toInt(p)]) continue;
+
+            // 'p' is the root of a component, pop it from the stack:
+            scc.clear();
+            Lit q;
+            do {
+                q = stack.last(); stack.pop();
+                scc.push(q);
+            } while (q != p);
+
+            // Pick its representative, or take it from the negated component if that is done:
+            Lit r = repr[toInt(~scc[0])] != lit_Undef ? ~repr[toInt(~scc[0])] : lit_Undef;
+            if (r == lit_Undef){
+                r = scc[0];
+                for (int i = 1; i < scc.size(); i++)
+                    if (frozen[var(scc[i])] > frozen[var(r)] || (frozen[var(scc[i])] == frozen[var(r)] && var(scc[i]) < var(r)))
+                        r = scc[i];
+            }
+            for (int i = 0; i < scc.size(); i++){
+                // A component with both 'x' and '~x' makes the clause set unsatisfiable:
+                if (vmark[var(scc[i])])
+                    return ok = false;
+                vmark[var(scc[i])] = 1;
+                repr[toInt(scc[i])] = r;
+            }
+            for (int i = 0; i < scc.size(); i++){
+                vmark[var(scc[i])] = 0;
+                if (!sign(scc[i]) && var(scc[i]) != var(r) && !frozen[var(scc[i])])
+                    subst++;
+            }
+        }
+    }
+
+    if (subst > 0){
+        // Mark the substituted variables as eliminated:
+        for (Var v = 0; v < max_var; v++){
+            Lit x = repr[toInt(mkLit(v))];
+            if (x == lit_Undef || var(x) == v || frozen[v])
+                repr[toInt(mkLit(v))] = repr[toInt(~mkLit(v))] = lit_Undef;
+            else{
+                eliminated[v] = true;
+                setDecisionVar(v, false);
+                mkEquivElimClauses(elimclauses, v, x);
+                substituted_vars++;
+            }
+        }
+
+        // Remove the learnt clauses of substituted variables (before they propagate anything):
+        for (i = j = 0; i < learnts.size(); i++){
+            const Clause& c = ca[learnts[i]];
+            for (int k = 0; k < c.size(); k++)
+                if (var(c[k]) < max_var && repr[toInt(c[k])] != lit_Undef){
+                    Solver::removeClause(learnts[i]);
+                    goto next; }
+            learnts[j++] = learnts[i];
+        next:;
+        }
+        learnts.shrink(i - j);
+
+        // Substitute the problem clauses:
+        vec<Lit>& subst_clause = add_tmp;
+        int       n_clauses    = clauses.size();
+        for (i = 0; i < n_clauses; i++){
+            const Clause& c = ca[clauses[i]];
+            if (c.mark()) continue;
+
+            int k;
+            for (k = 0; k < c.size(); k++)
+                if (var(c[k]) < max_var && repr[toInt(c[k])] != lit_Undef)
+                    break;
+            if (k == c.size()) continue;
+
+            subst_clause.clear();
+            for (k = 0; k < c.size(); k++){
+                Lit p = c[k];
+                subst_clause.push(var(p) < max_var && repr[toInt(p)] != lit_Undef ? repr[toInt(p)] : p);
+            }
+            removeClause(clauses[i]);
+            if (!addClause_(subst_clause))
+                return ok = false;
+        }
+    }
+
+    transitiveReduction();
+    removed = transred_bins - removed;
+
+    // Drop removed clauses (the search does not expect to find any in 'clauses'):
+    for (i = j = 0; i < clauses.size(); i++)
+        if (!isRemoved(clauses[i]))
+            clauses[j++] = clauses[i];
+    clauses.shrink(i - j);
+
+    if (verbosity >= 1 && (use_simplification || subst > 0 || removed > 0))
+        printf("|  Equivalent literals: %8d vars substituted, %8d binaries removed  |\n", subst, removed);
+
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  transitiveReduction : ()  ->  [void]
+|  
+|  Description:
+|    Remove binary problem clauses (a | b) where 'b' can be reached from '~a' over other binary
+|    problem clauses. The implied clause follows from the path, so it is redundant. Learnt
+|    binary clauses are not followed, since they may be removed later. At most 'transred_lim'
+|    implications are followed in total.
+|________________________________________________________________________________________________@*/
+void SimpSolver::transitiveReduction()
+{
+    assert(decisionLevel() == 0);
+
+    vec<uint32_t> stamp(2*nVars(), 0);
+    vec<Lit>      queue;
+    uint32_t      curr  = 0;
+    int64_t       steps = 0;
+
+    watches_bin.cleanAll();
+    for (int i = 0; i < clauses.size() && (transred_lim < 0 || steps < transred_lim); i++){
+        CRef          cr = clauses[i];
+        const Clause& c  = ca[cr];
+        if (c.mark() || c.size() != 2 || value(c[0]) != l_Undef || value(c[1]) != l_Undef) continue;
+
+        // Search from '~c[0]' for 'c[1]', without using this clause:
+        Lit from = ~c[0], to = c[1];
+        bool found = false;
+        curr++;
+        queue.clear();
+        queue.push(from);
+        stamp[toInt(from)] = curr;
+        for (int h = 0; h < queue.size() && !found; h++){
+            const vec<Watcher>& ws = watches_bin[queue[h]];
+            steps += ws.size();
+            for (int k = 0; k < ws.size(); k++){
+                Lit q = ws[k].blocker;
+                if (ws[k].cref == cr || stamp[toInt(q)] == curr || ca[ws[k].cref].learnt() || ca[ws[k].cref].mark()) continue;
+                if (q == to){ found = true; break; }
+                stamp[toInt(q)] = curr;
+                queue.push(q);
+            }
+        }
+
+        if (found){
+            transred_bins++;
+            removeClause(cr);
+        }
+    }
+}
+
+
 void SimpSolver::extendModel()
 {
     int i, j;
@@ -589,76 +1416,101 @@ void SimpSolver::extendModel()
         model[var(x)] = lbool(!sign(x));
     next:;
     }
+
+    // The variables added by 'boundedVarAddition()' are internal:
+    for (i = 0; i < added_vars.size(); i++)
+        model[added_vars[i]] = l_Undef;
 }
 
 
-bool SimpSolver::eliminate(bool turn_off_elim)
+// Main simplification loop: backward subsumption and elimination of the variables in 'elim_heap'
+// until nothing changes, the user interrupts or the budget runs out. Returns FALSE if the clause
+// set was found to be unsatisfiable.
+bool SimpSolver::eliminateLoop()
 {
-    if (!simplify())
-        return false;
-    else if (!use_simplification)
-        return true;
-
-    // Main simplification loop:
-    //
     while (n_touched > 0 || bwdsub_assigns < trail.size() || elim_heap.size() > 0){
 
         gatherTouchedClauses();
         // printf("  ## (time = %6.2f s) BWD-SUB: queue = %d, trail = %d\n", cpuTime(), subsumption_queue.size(), trail.size() - bwdsub_assigns);
         if ((subsumption_queue.size() > 0 || bwdsub_assigns < trail.size()) && 
-            !backwardSubsumptionCheck(true)){
-            ok = false; goto cleanup; }
+            !backwardSubsumptionCheck(simp_budget < 0))
+            return false;
 
-        // Empty elim_heap and return immediately on user-interrupt:
-        if (asynch_interrupt){
+        // Empty elim_heap and return immediately on user-interrupt (or when out of budget):
+        if (interrupted() || !withinSimpBudget()){
             assert(bwdsub_assigns == trail.size());
             assert(subsumption_queue.size() == 0);
             assert(n_touched == 0);
             elim_heap.clear();
-            goto cleanup; }
+            return true; }
 
         // printf("  ## (time = %6.2f s) ELIM: vars = %d\n", cpuTime(), elim_heap.size());
         for (int cnt = 0; !elim_heap.empty(); cnt++){
             Var elim = elim_heap.removeMin();
             
-            if (asynch_interrupt) break;
+            if (interrupted() || !withinSimpBudget()) break;
 
             if (isEliminated(elim) || value(elim) != l_Undef) continue;
 
-            if (verbosity >= 2 && cnt % 100 == 0)
+            if (verbosity >= 2 && cnt % 100 == 0 && simp_budget < 0)
                 printf("elimination left: %10d\r", elim_heap.size());
 
             if (use_asymm){
                 // Temporarily freeze variable. Otherwise, it would immediately end up on the queue again:
                 bool was_frozen = frozen[elim];
                 frozen[elim] = true;
-                if (!asymmVar(elim)){
-                    ok = false; goto cleanup; }
+                if (!asymmVar(elim))
+                    return false;
                 frozen[elim] = was_frozen; }
 
             // At this point, the variable may have been set by assymetric branching, so check it
             // again. Also, don't eliminate frozen variables:
-            if (use_elim && value(elim) == l_Undef && !frozen[elim] && !eliminateVar(elim)){
-                ok = false; goto cleanup; }
+            if (use_elim && value(elim) == l_Undef && !frozen[elim] && !eliminateVar(elim))
+                return false;
+
+            // If the variable was kept, remove the clauses blocked on it. Other variables in them
+            // lose occurrences, which puts them back on 'elim_heap':
+            if (use_bce && value(elim) == l_Undef && !frozen[elim] && !isEliminated(elim))
+                eliminateBlocked(elim);
 
             checkGarbage(simp_garbage_frac);
         }
 
         assert(subsumption_queue.size() == 0);
     }
- cleanup:
+
+    return true;
+}
+
+
+bool SimpSolver::eliminate(bool turn_off_elim)
+{
+    if (!simplify())
+        return false;
+    else if (!use_simplification)
+        return true;
+
+    int elim_before = eliminated_vars;
+    int bva_before  = bva_vars;
+    // (eliminate again only if bounded variable addition changed the clause set)
+    if ((use_equiv && !substituteEquivalences()) || (probe_lim > 0 && !probe(probe_lim)) || !eliminateLoop() ||
+        (use_bva && (!boundedVarAddition() || (bva_vars > bva_before && !eliminateLoop()))))
+        ok = false;
+    else if (eliminated_vars > elim_before)
+        removeEliminatedLearnts();
 
     // If no more simplification is needed, free all simplification-related data structures:
     if (turn_off_elim){
         touched  .clear(true);
         occurs   .clear(true);
-        n_occ    .clear(true);
         elim_heap.clear(true);
         subsumption_queue.clear(true);
+        if (!use_inproc_elim)
+            n_occ.clear(true);   // (otherwise kept to find the variables that lose occurrences later)
 
         use_simplification    = false;
         remove_satisfied      = true;
-        ca.extra_clause_field = false;
+        ca.extra_clause_field = use_inproc_elim;   // (re-elimination needs the abstractions for subsumption)
         max_simp_var          = nVars();
 
         // Force full cleanup (this is safe and desirable since it only happens once):
@@ -672,11 +1524,250 @@ bool SimpSolver::eliminate(bool turn_off_elim)
     if (verbosity >= 1 && elimclauses.size() > 0)
         printf("|  Eliminated clauses:     %10.2f Mb                                      |\n", 
                double(elimclauses.size() * sizeof(uint32_t)) / (1024*1024));
+    if (verbosity >= 1 && blocked_clauses > 0)
+        printf("|  Blocked clauses:        %10d removed                                   |\n", blocked_clauses);
+    if (verbosity >= 1 && gate_vars[gate_And] + gate_vars[gate_Xor] + gate_vars[gate_Ite] + gate_vars[gate_Equiv] > 0){
+        printf("|  Gate eliminations: AND %8d  XOR %8d  ITE %8d  EQV %8d      |\n",
+               gate_vars[gate_And], gate_vars[gate_Xor], gate_vars[gate_Ite], gate_vars[gate_Equiv]);
+        printf("|  Resolvents saved:  AND %8" PRIi64 "  XOR %8" PRIi64 "  ITE %8" PRIi64 "  EQV %8" PRIi64 "      |\n",
+               gate_saved[gate_And], gate_saved[gate_Xor], gate_saved[gate_Ite], gate_saved[gate_Equiv]); }
 
     return ok;
 }
 
 
+// Remove the learnt clauses with eliminated variables. They are implied by the original clauses,
+// but not by the remaining ones, and an eliminated variable should not be assigned by the search.
+// (This includes the hyper-binary resolvents added by probing before elimination.)
+void SimpSolver::removeEliminatedLearnts()
+{
+    int i, j;
+    for (i = j = 0; i < learnts.size(); i++){
+        const Clause& c = ca[learnts[i]];
+        for (int k = 0; k < c.size(); k++)
+            if (isEliminated(var(c[k]))){
+                Solver::removeClause(learnts[i]);   // (learnt clauses are not counted in 'n_occ')
+                goto next; }
+        learnts[j++] = learnts[i];
+    next:;
+    }
+    learnts.shrink(i - j);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  inprocess : ()  ->  [bool]
+|  
+|  Description:
+|    Repeat variable elimination between restarts, once 'eliminate(true)' has freed the occurrence
+|    lists. Runs at most every 'inproc_interval' conflicts. Only variables that lost occurrences
+|    since the last round are candidates (mostly through new top-level units, which satisfy or
+|    shorten clauses). Occurrence lists are rebuilt only for those variables. Other variables are
+|    marked in 'occ_partial'; they are not eliminated and are not used to find subsumed clauses.
+|
+|    The clauses of the candidates are checked for backward subsumption, and the candidates are
+|    passed to 'eliminateVar()' (which extends 'elimclauses'). The work is limited to 'inproc_eff'
+|    times the propagations made by the search since the last round.
+|
+|    Learnt clauses with a newly eliminated variable are removed. They are implied by the
+|    original clauses, but not by the remaining ones. An eliminated variable is no longer a
+|    decision variable, so keeping such clauses would only assign it spuriously.
+|
+|    Returns FALSE if the clause set was found to be unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool SimpSolver::inprocess()
+{
+    if (!use_inproc_elim || use_simplification || max_simp_var == 0 || conflicts < next_inproc)
+        return true;
+    assert(decisionLevel() == 0);
+    assert(ca.extra_clause_field);
+    next_inproc = conflicts + inproc_interval;
+
+    if (!simplify() || (use_equiv && !substituteEquivalences()))
+        return ok = false;
+
+    // Count the occurrences again, and find the variables that lost some since the last round. The
+    // abstractions are recomputed since top-level simplification may have removed literals:
+    vec<int> cnt(2*nVars(), 0);
+    for (int i = 0; i < clauses.size(); i++){
+        Clause& c = ca[clauses[i]];
+        c.calcAbstraction();
+        for (int j = 0; j < c.size(); j++)
+            cnt[toInt(c[j])]++;
+    }
+
+    vec<Var> cands;
+    for (Var v = 0; v < max_simp_var; v++)    // (variables introduced later are never eliminated)
+        if (!frozen[v] && !isEliminated(v) && value(v) == l_Undef &&
+            (cnt[toInt(mkLit(v))] < n_occ[mkLit(v)] || cnt[toInt(~mkLit(v))] < n_occ[~mkLit(v)]))
+            cands.push(v);
+
+    n_occ.reserve(~mkLit(nVars()-1), 0);
+    for (int i = 0; i < cnt.size(); i++)
+        n_occ[toLit(i)] = cnt[i];
+
+    if (cands.size() == 0){
+        inproc_props = propagations;
+        return true; }
+
+    // Rebuild the occurrence lists of the candidates, and queue their clauses for subsumption:
+    use_simplification = true;
+    inproc_rounds++;
+    touched.reserve(nVars()-1, 0);
+    for (Var v = 0; v < nVars(); v++){
+        occurs.init(v);
+        occ_partial[v] = 1; }
+    for (int i = 0; i < cands.size(); i++){
+        occ_partial[cands[i]] = 0;
+        touched    [cands[i]] = 1;
+        elim_heap.insert(cands[i]); }
+    n_touched = cands.size();
+
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        for (int j = 0; j < c.size(); j++)
+            if (!occ_partial[var(c[j])])
+                occurs[var(c[j])].push(clauses[i]);
+    }
+
+    vec<Lit> dummy(1,lit_Undef);
+    bwdsub_tmpunit = ca.alloc(dummy);
+    bwdsub_assigns = trail.size();
+
+    int elim_before = eliminated_vars;
+    simp_budget     = simp_ticks + (int64_t)((propagations - inproc_props) * inproc_eff);
+    bool res        = eliminateLoop();
+    simp_budget     = -1;
+
+    // Free the occurrence lists again:
+    ca.free(bwdsub_tmpunit);
+    touched  .clear(true);
+    occurs   .clear(true);
+    elim_heap.clear(true);
+    subsumption_queue.clear(true);
+    for (Var v = 0; v < nVars(); v++)
+        occ_partial[v] = 0;
+    n_touched          = 0;
+    use_simplification = false;
+
+    if (!res)
+        return ok = false;
+
+    // Drop removed clauses (the search does not expect to find any in 'clauses'):
+    int i, j;
+    for (i = j = 0; i < clauses.size(); i++)
+        if (!isRemoved(clauses[i]))
+            clauses[j++] = clauses[i];
+    clauses.shrink(i - j);
+
+    if (verbosity >= 2)
+        printf("|  Re-elimination:  %8d candidates, %8d eliminated                      |\n",
+               cands.size(), eliminated_vars - elim_before);
+
+    if (eliminated_vars > elim_before){
+        removeEliminatedLearnts();
+        rebuildOrderHeap();
+    }
+
+    checkGarbage();
+    inproc_props = propagations;
+    return true;
+}
+
+
+//=================================================================================================
+// Checkpoints:
+
+
+// Adds the elimination state to that of 'Solver' (the clauses eliminated so far are needed to
+// extend models). Occurrence lists are not written: if simplification is still on when restoring,
+// they are built again from the clauses, which are then all queued for subsumption as if new.
+void SimpSolver::saveState(CheckpointWriter& out)
+{
+    Solver::saveState(out);
+
+    vec<char> fro, eli, par;
+    vec<int>  occ;
+    for (Var v = 0; v < nVars(); v++){
+        fro.push(frozen[v]);
+        eli.push(eliminated[v]);
+        par.push(occ_partial[v]); }
+    for (const int* n = n_occ.begin(); n != n_occ.end(); n++)
+        occ.push(*n);
+
+    out.put(use_simplification);
+    out.put(max_simp_var);
+    out.put(elimorder);
+    out.put(elimclauses);
+    out.put(fro);
+    out.put(eli);
+    out.put(par);
+    out.put(frozen_vars);
+    out.put(added_vars);
+    out.put(occ);
+    out.put(bwdsub_tmpunit);
+    out.put(bwdsub_assigns);
+    out.put(next_inproc);
+    out.put(inproc_props);
+    out.put(simp_ticks);
+    out.put(simp_budget);
+
+    int stats[] = { merges, asymm_lits, eliminated_vars, blocked_clauses, bva_vars, bva_saved, substituted_vars,
+                    transred_bins, inproc_rounds };
+    out.put(stats, sizeof(stats) / sizeof(stats[0]));
+    out.put(gate_vars, 4);
+    out.put(gate_saved, 4);
+}
+
+
+bool SimpSolver::loadState(CheckpointReader& in)
+{
+    if (!Solver::loadState(in))
+        return false;
+
+    // ('Solver::loadState()' made the variables without the maps of this class)
+    vec<char> fro, eli, par;
+    vec<int>  occ;
+    if (!in.get(use_simplification) || !in.get(max_simp_var) || !in.get(elimorder) || !in.get(elimclauses) ||
+        !in.get(fro, nVars()) || !in.get(eli, nVars()) || !in.get(par, nVars()) ||
+        !in.get(frozen_vars, nVars()) || !in.get(added_vars, nVars()) || !in.get(occ, 2*nVars()) ||
+        fro.size() != nVars() || eli.size() != nVars() || par.size() != nVars() || (occ.size() != 0 && occ.size() != 2*nVars()) ||
+        !in.get(bwdsub_tmpunit) || bwdsub_tmpunit >= ca.size() || ca.words(bwdsub_tmpunit) > ca.size() - bwdsub_tmpunit || !in.get(bwdsub_assigns) ||
+        !in.get(next_inproc) || !in.get(inproc_props) || !in.get(simp_ticks) || !in.get(simp_budget))
+        return in.fail();
+
+    int* stats[] = { &merges, &asymm_lits, &eliminated_vars, &blocked_clauses, &bva_vars, &bva_saved, &substituted_vars,
+                     &transred_bins, &inproc_rounds };
+    for (unsigned i = 0; i < sizeof(stats) / sizeof(stats[0]); i++)
+        if (!in.get(*stats[i])) return false;
+    if (!in.get(gate_vars, 4) || !in.get(gate_saved, 4))
+        return false;
+
+    for (Var v = 0; v < nVars(); v++){
+        frozen     .insert(v, fro[v]);
+        eliminated .insert(v, eli[v]);
+        occ_partial.insert(v, par[v]); }
+
+    n_occ.clear();
+    if (use_simplification){
+        for (Var v = 0; v < nVars(); v++){
+            n_occ  .insert( mkLit(v), 0);
+            n_occ  .insert(~mkLit(v), 0);
+            occurs .init  (v);
+            touched.insert(v, 0);
+            if (!frozen[v] && !isEliminated(v) && value(v) == l_Undef)
+                elim_heap.insert(v);
+        }
+        registerClauses(0);
+    }else
+        for (int i = 0; i < occ.size(); i++)
+            n_occ.insert(toLit(i), occ[i], 0);
+
+    return true;
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
@@ -719,7 +1810,7 @@ void SimpSolver::garbageCollect()
     relocAll(to);
     Solver::relocAll(to);
     if (verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n", 
-               ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
+        printf("|  Garbage collection:   %12" PRIu64 " bytes => %12" PRIu64 " bytes             |\n", 
+               (uint64_t)ca.size()*ClauseAllocator::Unit_Size, (uint64_t)to.size()*ClauseAllocator::Unit_Size);
     to.moveTo(ca);
 }
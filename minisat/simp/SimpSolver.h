@@ -21,6 +21,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_SimpSolver_h
 #define Minisat_SimpSolver_h
 
+#include <atomic>
+
 #include "minisat/mtl/Queue.h"
 #include "minisat/core/Solver.h"
 
@@ -48,6 +50,7 @@ class SimpSolver : public Solver {
     bool    addClause (Lit p, Lit q, Lit r); // Add a ternary clause to the solver.
     bool    addClause (Lit p, Lit q, Lit r, Lit s); // Add a quaternary clause to the solver. 
     bool    addClause_(      vec<Lit>& ps);
+    bool    addClauses(const uint32_t* sizes, const uint32_t* lits, uint64_t n_clauses); // Add clauses in bulk (see 'Solver::addClauses()').
     bool    substitute(Var v, Lit x);  // Replace all occurences of v with x (may cause a contradiction).
 
     // Variable mode:
@@ -91,18 +94,40 @@ class SimpSolver : public Solver {
     int     clause_lim;        // Variables are not eliminated if it produces a resolvent with a length above this limit.
                                // -1 means no limit.
     int     subsumption_lim;   // Do not check if subsumption against a clause larger than this. -1 means no limit.
+    int     sub_threads;       // Number of threads for backward subsumption of large queues (0 = one per hardware thread).
+    int     sub_par_min;       // Check the subsumption queue in parallel when it holds at least this many clauses. -1 means never.
     double  simp_garbage_frac; // A different limit for when to issue a GC during simplification (Also see 'garbage_frac').
 
     bool    use_asymm;         // Shrink clauses by asymmetric branching.
     bool    use_rcheck;        // Check if a clause is already implied. Prett costly, and subsumes subsumptions :)
     bool    use_elim;          // Perform variable elimination.
+    bool    use_bce;           // Remove blocked clauses (on variables that are not eliminated).
+    bool    use_gates;         // Only add the resolvents with gate clauses when eliminating a variable defined by a gate.
+    int     bce_lim;           // Do not look for clauses blocked on 'l' if '~l' occurs more often than this. -1 means no limit.
+    bool    use_equiv;         // Substitute equivalent literals (found as cycles of binary clauses).
+    int     transred_lim;      // Limit on the implications followed by transitive reduction in one pass. -1 means no limit.
+    int     probe_lim;         // Limit on the propagations of failed literal probing before elimination. 0 means no probing.
+    bool    use_bva;           // Replace clause patterns by fewer clauses over a new variable (bounded variable addition).
+    int     bva_min;           // Only replace a pattern if it saves at least this many clauses.
+    int     bva_lim;           // Limit on the clauses visited by bounded variable addition. -1 means no limit.
     bool    extend_model;      // Flag to indicate whether the user needs to look at the full model.
+    bool    use_inproc_elim;   // Repeat variable elimination during search, after 'eliminate(true)'.
+    int     inproc_interval;   // Minimum number of conflicts between two rounds of re-elimination.
+    double  inproc_eff;        // Work allowed in a round of re-elimination, relative to the propagations of the search.
 
     // Statistics:
     //
     int     merges;
     int     asymm_lits;
     int     eliminated_vars;
+    int     blocked_clauses;
+    int     gate_vars [4];     // Variables eliminated through an AND, XOR, ITE or equivalence gate definition.
+    int64_t gate_saved[4];     // Resolvents not generated thanks to these gates (pairs of non-gate clauses).
+    int     bva_vars;
+    int     bva_saved;
+    int     substituted_vars;
+    int     transred_bins;
+    int     inproc_rounds;
 
  protected:
 
@@ -124,6 +149,16 @@ class SimpSolver : public Solver {
         //     return c_x < c_y || c_x == c_y && x < y; }
     };
 
+    enum { sub_chunk = 256 };            // Number of subsumers in one unit of work of 'parallelSubsumption()'.
+
+    enum { gate_None = -1, gate_And = 0, gate_Xor = 1, gate_Ite = 2, gate_Equiv = 3 };
+
+    struct BvaLt {
+        const LMap<int>& n_occ;
+        explicit BvaLt(const LMap<int>& no) : n_occ(no) {}
+        bool operator()(Lit x, Lit y) const { return n_occ[x] > n_occ[y]; }
+    };
+
     struct ClauseDeleted {
         const ClauseAllocator& ca;
         explicit ClauseDeleted(const ClauseAllocator& _ca) : ca(_ca) {}
@@ -139,17 +174,26 @@ class SimpSolver : public Solver {
     OccLists<Var, vec<CRef>, ClauseDeleted>
                         occurs;
     LMap<int>           n_occ;
-    Heap<Var,ElimLt>    elim_heap;
+    Heap<Var,ElimLt,MkIndexDefault<Var>,MINISAT_HEAP_ARITY>
+                        elim_heap;
     Queue<CRef>         subsumption_queue;
     VMap<char>          frozen;
     vec<Var>            frozen_vars;
     VMap<char>          eliminated;
+    vec<Var>            added_vars;          // Variables introduced by bounded variable addition (not part of the model).
     int                 bwdsub_assigns;
     int                 n_touched;
+    VMap<char>          occ_partial;         // (inprocessing) 'occurs[v]' may miss clauses, so 'v' is not eliminated or used in subsumption.
+    uint64_t            next_inproc;         // Number of conflicts at which the next round of re-elimination may run.
+    uint64_t            inproc_props;        // Number of propagations at the end of the last round of re-elimination.
+    uint64_t            simp_ticks;          // Work done in subsumption and resolution (candidates checked, clauses merged).
+    int64_t             simp_budget;         // Stop simplifying when 'simp_ticks' reaches this. -1 means no budget.
 
     // Temporaries:
     //
     CRef                bwdsub_tmpunit;
+    vec<char>           gate_seen;
+    vec<char>           pos_gate, neg_gate;
 
     // Main internal methods:
     //
@@ -161,7 +205,21 @@ class SimpSolver : public Solver {
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause);
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, int& size);
     bool          backwardSubsumptionCheck (bool verbose = false);
+    bool          parallelSubsumption      ();
+    void          subsumptionWorker        (const vec<CRef>& cands, vec<vec<CRef> >& found, std::atomic<int>& next_chunk, std::atomic<uint64_t>& ticks);
     bool          eliminateVar             (Var v);
+    void          eliminateBlocked         (Var v);
+    int           findGate                 (Var v, const vec<CRef>& pos, const vec<CRef>& neg, vec<char>& pos_gate, vec<char>& neg_gate);
+    bool          boundedVarAddition       ();
+    bool          eliminateLoop            ();
+    bool          substituteEquivalences   ();
+    void          transitiveReduction      ();
+    void          removeEliminatedLearnts  ();
+    virtual bool  inprocess                ();
+    virtual void  saveState                (CheckpointWriter& out);
+    virtual bool  loadState                (CheckpointReader& in);
+    void          registerClauses          (int from);   // Add 'clauses[from..]' to the occurrence lists and the subsumption queue.
+    bool          withinSimpBudget         () const;
     void          extendModel              ();
 
     void          removeClause             (CRef cr);
@@ -179,8 +237,9 @@ inline bool SimpSolver::isEliminated (Var v) const { return eliminated[v]; }
 inline void SimpSolver::updateElimHeap(Var v) {
     assert(use_simplification);
     // if (!frozen[v] && !isEliminated(v) && value(v) == l_Undef)
-    if (elim_heap.inHeap(v) || (!frozen[v] && !isEliminated(v) && value(v) == l_Undef))
+    if (elim_heap.inHeap(v) || (!frozen[v] && !isEliminated(v) && !occ_partial[v] && value(v) == l_Undef))
         elim_heap.update(v); }
+inline bool SimpSolver::withinSimpBudget() const { return simp_budget < 0 || simp_ticks < (uint64_t)simp_budget; }
 
 
 inline bool SimpSolver::addClause    (const vec<Lit>& ps)    { ps.copyTo(add_tmp); return addClause_(add_tmp); }
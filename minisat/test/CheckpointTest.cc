@@ -0,0 +1,186 @@
+/*******************************************************************************[CheckpointTest.cc]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+// Tests for 'Solver::checkpoint()' and 'Solver::restore()' with chronological backtracking
+// ('-chrono=0'), where the top-level literals kept by backtracking are queued to be propagated
+// again, and may be in a checkpoint before that:
+//
+//   kept    -- a top-level literal 'u' is enqueued at level 1, and kept by backtracking to level 0
+//              before it is propagated. The clause '(~u | a | b | c)' still watches '~u' then, and
+//              only propagating 'u' moves that watch. This state is checkpointed and restored.
+//   slices  -- random 3-SAT instances around the threshold are solved in short slices of
+//              conflicts. After each slice the solver is replaced by one restored from a checkpoint.
+//              The answer must agree with an uninterrupted solver, and every model must satisfy
+//              the instance.
+//
+// After each restore, the solver must keep the watch invariant once propagated: a clause (longer
+// than ternary) that is not satisfied has no false watch.
+//
+// Usage: minisat_checkpointtest [file]   (the checkpoint file, by default in the current directory)
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "minisat/mtl/Rnd.h"
+#include "minisat/core/Solver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+
+
+static void randomCnf(double& seed, int n_vars, int n_clauses, vec<vec<Lit> >& cnf)
+{
+    cnf.clear();
+    for (int i = 0; i < n_clauses; i++){
+        cnf.push();
+        while (cnf.last().size() < 3){
+            Lit p = mkLit(irand(seed, n_vars), irand(seed, 2));
+            bool dup = false;
+            for (int k = 0; k < cnf.last().size(); k++)
+                dup |= var(cnf.last()[k]) == var(p);
+            if (!dup) cnf.last().push(p);
+        }
+    }
+}
+
+
+// Gives the test access to the clause database of the solver:
+class TestSolver : public Solver {
+public:
+    TestSolver() {
+        verbosity       = 0;
+        chrono          = 0;
+        confl_to_chrono = 0; }
+
+    // Build the state of the 'kept' test (the variables are 'u', 'a', 'b', 'c', in this order, so
+    // that the clause watches '~u' and 'a'):
+    void keptState() {
+        for (int i = 0; i < 4; i++) newVar();
+        Lit u = mkLit(0), a = mkLit(1), b = mkLit(2), c = mkLit(3);
+        addClause(~u, a, b, c);
+        newDecisionLevel();
+        uncheckedEnqueue(~a);
+        propagate();
+        uncheckedEnqueue(u, 0, CRef_Undef);
+        cancelUntil(0);
+        assert(value(u) == l_True && value(a) == l_Undef); }
+
+    // Propagate at the top level, and check the watches of the clauses watched on two literals:
+    bool watchesValid() {
+        if (!okay() || propagate() != CRef_Undef) return true;
+        for (int i = 0; i < clauses.size() + learnts.size(); i++){
+            const Clause& c = ca[i < clauses.size() ? clauses[i] : learnts[i - clauses.size()]];
+            if (c.size() <= 3 || (value(c[0]) != l_False && value(c[1]) != l_False)) continue;
+            bool sat = false;
+            for (int k = 0; k < c.size(); k++)
+                sat |= value(c[k]) == l_True;
+            if (!sat) return false;
+        }
+        return true; }
+};
+
+
+static void load(Solver& S, int n_vars, const vec<vec<Lit> >& cnf)
+{
+    while (S.nVars() < n_vars) S.newVar();
+    for (int i = 0; i < cnf.size(); i++)
+        S.addClause(cnf[i]);
+}
+
+
+static bool satisfies(const Solver& S, const vec<vec<Lit> >& cnf)
+{
+    for (int i = 0; i < cnf.size(); i++){
+        bool sat = false;
+        for (int k = 0; k < cnf[i].size(); k++)
+            sat |= S.modelValue(cnf[i][k]) == l_True;
+        if (!sat) return false; }
+    return true;
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* file     = argc > 1 ? argv[1] : "checkpoint_test.ckpt";
+    double      seed     = 91648253;
+    int         failures = 0;
+    int         restores = 0;
+    int         n_insts  = 20;
+
+    // kept:
+    {
+        TestSolver S;
+        S.keptState();
+        if (!S.checkpoint(file)){
+            fprintf(stderr, "kept: could not write the checkpoint %s\n", file);
+            return 1; }
+        TestSolver R;
+        if (!R.restore(file)){
+            fprintf(stderr, "kept: could not restore the checkpoint %s\n", file);
+            return 1; }
+        bool ok = R.watchesValid() && R.solve() && R.modelValue(mkLit(0)) == l_True;
+        printf("kept: %s\n", ok ? "ok" : "FAILED (watches broken after a restore)");
+        failures += !ok;
+    }
+
+    // slices:
+    for (int inst = 0; inst < n_insts; inst++){
+        int            n_vars = 150;
+        vec<vec<Lit> > cnf;
+        randomCnf(seed, n_vars, 639, cnf);
+
+        TestSolver ref;
+        load(ref, n_vars, cnf);
+        lbool expected = ref.solveLimited(vec<Lit>());
+
+        TestSolver* S = new TestSolver;
+        load(*S, n_vars, cnf);
+        lbool result = l_Undef;
+        bool  broken = false;
+        for (int slice = 0; result == l_Undef && slice < 10000; slice++){
+            S->setConfBudget(20);
+            result = S->solveLimited(vec<Lit>());
+            if (result != l_Undef) break;
+
+            if (!S->checkpoint(file)){
+                fprintf(stderr, "instance %d: could not write the checkpoint %s\n", inst, file);
+                return 1; }
+            delete S;
+            S = new TestSolver;
+            if (!S->restore(file)){
+                fprintf(stderr, "instance %d: could not restore the checkpoint %s\n", inst, file);
+                return 1; }
+            restores++;
+            broken |= !S->watchesValid();
+        }
+
+        if (broken || result != expected || (result == l_True && !satisfies(*S, cnf))){
+            printf("instance %d: FAILED (got %s, expected %s%s)\n", inst,
+                   result == l_True ? "SAT" : result == l_False ? "UNSAT" : "UNKNOWN",
+                   expected == l_True ? "SAT" : "UNSAT", broken ? ", watches broken after a restore" : "");
+            failures++; }
+        delete S;
+    }
+    remove(file);
+
+    printf("slices: %d instances, %d restores\n%d failures\n", n_insts, restores, failures);
+    return failures > 0;
+}
@@ -0,0 +1,106 @@
+/************************************************************************************[ParseUtils.cc]
+Copyright (c) 2003-2006, Niklas Een, Niklas Sorensson
+Copyright (c) 2007-2010, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <stdlib.h>
+
+#include "minisat/utils/ParseUtils.h"
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#define MINISAT_NO_MMAP
+#include <string.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace Minisat;
+
+//=================================================================================================
+// MappedFile:
+
+
+#if !defined(MINISAT_NO_MMAP)
+
+bool MappedFile::open(const char* file)
+{
+    close();
+    int fd = ::open(file, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)){
+        ::close(fd);
+        return false; }
+
+    sz = (size_t)st.st_size;
+    if (sz > 0){
+        void* mem = mmap(NULL, sz, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mem == MAP_FAILED){
+            ::close(fd);
+            sz = 0;
+            return false; }
+        madvise(mem, sz, MADV_SEQUENTIAL);
+        buf    = (const char*)mem;
+        mapped = true;
+    }
+    ::close(fd);
+    return true;
+}
+
+
+void MappedFile::close()
+{
+    if (mapped) munmap((void*)buf, sz);
+    buf    = NULL;
+    sz     = 0;
+    mapped = false;
+}
+
+#else
+
+bool MappedFile::open(const char* file)
+{
+    close();
+    FILE* f = fopen(file, "rb");
+    if (f == NULL) return false;
+
+    char   chunk[64*1024];
+    char*  mem = NULL;
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0){
+        mem = (char*)xrealloc(mem, sz + n);
+        memcpy(mem + sz, chunk, n);
+        sz += n; }
+    fclose(f);
+    buf = mem;
+    return true;
+}
+
+
+void MappedFile::close()
+{
+    free((void*)buf);
+    buf = NULL;
+    sz  = 0;
+}
+
+#endif
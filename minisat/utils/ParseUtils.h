@@ -62,10 +62,51 @@ public:
 
 
 //-------------------------------------------------------------------------------------------------
-// End-of-file detection functions for StreamBuffer and char*:
+// A character stream over a block of memory:
+
+
+class MemBuffer {
+    const char* pos;
+    const char* end;
+
+public:
+    MemBuffer(const char* b, const char* e) : pos(b), end(e) {}
+
+    int  operator *  () const { return (pos >= end) ? EOF : (unsigned char)*pos; }
+    void operator ++ ()       { pos++; }
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// A read-only file mapped into memory (or read into it, where mapping is not supported):
+
+
+class MappedFile {
+    const char* buf;
+    size_t      sz;
+    bool        mapped;
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+public:
+    MappedFile() : buf(NULL), sz(0), mapped(false) {}
+    ~MappedFile() { close(); }
+
+    bool        open  (const char* file);  // Returns FALSE if 'file' is not a regular file that can be read.
+    void        close ();
+    const char* data  () const { return buf; }
+    size_t      size  () const { return sz; }
+    bool        isGzip() const { return sz >= 2 && (unsigned char)buf[0] == 0x1f && (unsigned char)buf[1] == 0x8b; }
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// End-of-file detection functions for StreamBuffer, MemBuffer and char*:
 
 
 static inline bool isEof(StreamBuffer& in) { return *in == EOF;  }
+static inline bool isEof(MemBuffer&    in) { return *in == EOF;  }
 static inline bool isEof(const char*   in) { return *in == '\0'; }
 
 //-------------------------------------------------------------------------------------------------
@@ -32,6 +32,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 namespace Minisat {
 
 static inline double cpuTime(void); // CPU-time in seconds.
+static inline double realTime(void);// Wall-clock time in seconds.
 
 extern double memUsed();            // Memory in mega bytes (returns 0 for unsupported architectures).
 extern double memUsedPeak(bool strictlyPeak = false); // Peak-memory in mega bytes (returns 0 for unsupported architectures).
@@ -56,6 +57,7 @@ extern void   sigTerm(void handler(int));      // Set up handling of available t
 #include <time.h>
 
 static inline double Minisat::cpuTime(void) { return (double)clock() / CLOCKS_PER_SEC; }
+static inline double Minisat::realTime(void) { return (double)time(NULL); }
 
 #else
 #include <sys/time.h>
@@ -67,6 +69,11 @@ static inline double Minisat::cpuTime(void) {
     getrusage(RUSAGE_SELF, &ru);
     return (double)ru.ru_utime.tv_sec + (double)ru.ru_utime.tv_usec / 1000000; }
 
+static inline double Minisat::realTime(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1000000; }
+
 #endif
 
 #endif